@@ -15,7 +15,12 @@ LOCAL_SRC_FILES := \
 	model/Point.cpp\
 	model/WorldObject.cpp\
 	model/WorldObjectMove.cpp\
+	model/Speed.cpp\
 	model/World.cpp\
+	model/Snapshot.cpp\
+	model/LevelBlob.cpp\
+	model/Flood.cpp\
+	model/NavTable.cpp\
 	model/Player.cpp\
 	model/Brick.cpp\
 	model/Spirit/Spirit.cpp\
@@ -26,7 +31,12 @@ LOCAL_SRC_FILES := \
 	pacmanlib.cpp \
 	View/Art.cpp \
 	View/WorldRenderer.cpp \
+	View/MazeMesh.cpp \
 	Controller/WorldController.cpp \
+	Controller/Replay.cpp \
+	Controller/RewindBuffer.cpp \
+	Controller/InputLatency.cpp \
+	Controller/LevelLoader.cpp \
 	Controller/SoundController.cpp \
 	Sound/OSLContext.cpp \
 	Sound/OSLSound.cpp \
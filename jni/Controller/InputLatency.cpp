@@ -0,0 +1,81 @@
+#include "Controller/InputLatency.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+uint64_t monotonicNanos() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void LatencyWindow::add(uint64_t nanos) {
+	samples[head] = nanos;
+	head = (head + 1) % WINDOW;
+	if (count < WINDOW)
+		count++;
+}
+
+static int compareSamples(const void* a, const void* b) {
+	uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+	return x < y ? -1 : x > y;
+}
+
+// Sorts a copy, so the window keeps its order; asked for a few times a
+// second at most.
+uint64_t LatencyWindow::percentile(double fraction) const {
+	if (count == 0)
+		return 0;
+	uint64_t sorted[WINDOW];
+	memcpy(sorted, samples, count * sizeof(uint64_t));
+	qsort(sorted, count, sizeof(uint64_t), compareSamples);
+	int rank = (int) (fraction * count + 0.999999);
+	if (rank < 1)
+		rank = 1;
+	if (rank > count)
+		rank = count;
+	return sorted[rank - 1];
+}
+
+InputLatency::InputLatency() {
+	turns = 0;
+	pending = false;
+	turnTick = 0;
+	turnWaited = 0;
+	inputTime = 0;
+	turnTime = 0;
+	log = NULL;
+}
+
+void InputLatency::setLog(FILE* file) {
+	log = file;
+	if (log)
+		fprintf(log, "turn_tick,waited_ticks,input_to_tick_ns,tick_to_frame_ns,input_to_frame_ns\n");
+}
+
+// Turns held over from a restored game have no touch to measure from.
+void InputLatency::turned(long tick, int waited, uint64_t input, uint64_t now) {
+	if (input == 0 || input > now)
+		return;
+	turns++;
+	windows[INPUT_TO_TICK].add(now - input);
+	pending = true;
+	turnTick = tick;
+	turnWaited = waited;
+	inputTime = input;
+	turnTime = now;
+}
+
+void InputLatency::frame(uint64_t now) {
+	if (!pending)
+		return;
+	pending = false;
+	windows[TICK_TO_FRAME].add(now - turnTime);
+	windows[INPUT_TO_FRAME].add(now - inputTime);
+	if (log)
+		fprintf(log, "%ld,%d,%llu,%llu,%llu\n", turnTick, turnWaited,
+				(unsigned long long) (turnTime - inputTime),
+				(unsigned long long) (now - turnTime),
+				(unsigned long long) (now - inputTime));
+}
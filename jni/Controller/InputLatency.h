@@ -0,0 +1,67 @@
+#ifndef InputLatency_H_
+#define InputLatency_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Monotonic clock in ns, for stamping touches as they arrive.
+uint64_t monotonicNanos();
+
+// Stages a swipe goes through before it shows: from the touch arriving to
+// the tick that turns the player, and from that tick to the end of the
+// frame that first draws the player's new texture.
+enum LatencyStage {
+	INPUT_TO_TICK,
+	TICK_TO_FRAME,
+	INPUT_TO_FRAME,
+	LATENCY_STAGES
+};
+
+// The last WINDOW samples of one stage, in ns.
+class LatencyWindow {
+public:
+	static const int WINDOW = 256;
+	LatencyWindow() : head(0), count(0) {}
+	void add(uint64_t nanos);
+	// Smallest sample with at least fraction of the window at or under it,
+	// or 0 if there are none yet.
+	uint64_t percentile(double fraction) const;
+	int size() const { return count; }
+private:
+	uint64_t samples[WINDOW];
+	int head;
+	int count;
+};
+
+// Follows each turn from its touch to the frame that shows it. The
+// controller reports turns and the render loop reports frames; a turn
+// replaced by another before any frame is drawn never shows, so it only
+// counts towards the first stage.
+class InputLatency {
+public:
+	InputLatency();
+	// The player turned on tick for a touch stamped input (0 if unknown).
+	void turned(long tick, int waited, uint64_t input, uint64_t now);
+	// A frame finished drawing at now.
+	void frame(uint64_t now);
+	uint64_t percentile(int stage, double fraction) const {
+		return windows[stage].percentile(fraction);
+	}
+	int size(int stage) const { return windows[stage].size(); }
+	long getTurns() const { return turns; }
+	// Writes a row per shown turn to file, which stays the caller's.
+	void setLog(FILE* file);
+private:
+	LatencyWindow windows[LATENCY_STAGES];
+	long turns;
+	bool pending;
+	long turnTick;
+	int turnWaited;
+	uint64_t inputTime;
+	uint64_t turnTime;
+	FILE* log;
+	InputLatency(const InputLatency&);
+	InputLatency& operator=(const InputLatency&);
+};
+
+#endif /* InputLatency_H_ */
@@ -0,0 +1,70 @@
+#include "Controller/LevelLoader.h"
+
+LevelLoader::LevelLoader(ReadLevel* reader) {
+	this->reader = reader;
+	spare = new Level();
+	pending = -1;
+	loaded = false;
+	running = false;
+}
+
+LevelLoader::~LevelLoader() {
+	finish();
+	delete spare;
+}
+
+void* LevelLoader::run(void* arg) {
+	LevelLoader* loader = (LevelLoader*) arg;
+	loader->loaded = loader->reader->loadLevel(loader->pending, loader->spare);
+	return NULL;
+}
+
+void LevelLoader::finish() {
+	if (running) {
+		pthread_join(thread, NULL);
+		running = false;
+	}
+}
+
+// Starts reading level number into the spare level, unless it is already
+// there or on its way. Loads on the calling thread if no thread can be had.
+void LevelLoader::preload(int number) {
+	if (pending == number)
+		return;
+	finish();
+	pending = number;
+	if (pthread_create(&thread, NULL, run, this) == 0)
+		running = true;
+	else
+		run(this);
+}
+
+// Level number as take() would return it, without swapping it in: the
+// reader's current level stays current. NULL if it cannot be loaded.
+const Level* LevelLoader::peek(int number) {
+	if (pending != number)
+		preload(number);
+	finish();
+	if (!loaded) {
+		pending = -1;	// asked again, it is read again
+		return NULL;
+	}
+	return spare;
+}
+
+// Makes level number the reader's current level and returns it, waiting
+// for the preload if it is still running or loading it now if it was never
+// asked for. The level it replaces becomes the spare, so the caller must
+// be done with it. NULL if the level cannot be loaded.
+Level* LevelLoader::take(int number) {
+	if (pending != number)
+		preload(number);
+	finish();
+	pending = -1;
+	if (!loaded)
+		return NULL;
+	Level* next = spare;
+	spare = reader->level;
+	reader->level = next;
+	return next;
+}
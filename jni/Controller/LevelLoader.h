@@ -0,0 +1,32 @@
+#ifndef LevelLoader_H_
+#define LevelLoader_H_
+
+#include <pthread.h>
+#include "model/ReadLevel.h"
+
+// Loads the next level of the pack on a background thread while the
+// current one is played, into a spare Level that take() swaps with the
+// reader's current one. The two Levels and their buffers are reused from
+// level to level.
+class LevelLoader {
+public:
+	LevelLoader(ReadLevel* reader);
+	~LevelLoader();
+	void preload(int number);
+	const Level* peek(int number);
+	Level* take(int number);
+	bool isLoading() {return running;}
+private:
+	ReadLevel* reader;
+	Level* spare;
+	int pending;	// level being loaded into spare, or -1
+	bool loaded;	// whether pending loaded, once the thread is joined
+	bool running;
+	pthread_t thread;
+	static void* run(void* loader);
+	void finish();
+	LevelLoader(const LevelLoader&);
+	LevelLoader& operator=(const LevelLoader&);
+};
+
+#endif /* LevelLoader_H_ */
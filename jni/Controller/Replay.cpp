@@ -0,0 +1,372 @@
+#include "Controller/Replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Controller/WorldController.h"
+#include "model/Direction.h"
+#include "model/World.h"
+#include "log.h"
+
+static const char REPLAY_MAGIC[4] = { 'P', 'R', 'P', 'L' };
+static const int SNAPSHOT_WORDS = sizeof(Snapshot) / sizeof(uint32_t);
+
+static uint32_t zigzag(int32_t value) {
+	return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+	return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+ReplayBuffer::ReplayBuffer() {
+	bytes = NULL;
+	count = 0;
+	capacity = 0;
+}
+
+ReplayBuffer::~ReplayBuffer() {
+	free(bytes);
+}
+
+void ReplayBuffer::putByte(uint8_t value) {
+	if (count == capacity) {
+		capacity = capacity ? capacity * 2 : 4096;
+		bytes = (uint8_t*) realloc(bytes, capacity);
+	}
+	bytes[count++] = value;
+}
+
+void ReplayBuffer::putVarint(uint32_t value) {
+	while (value >= 0x80) {
+		putByte((uint8_t) (value | 0x80));
+		value >>= 7;
+	}
+	putByte((uint8_t) value);
+}
+
+// Snapshot fields are small signed ints and sparse bitsets, so each 32-bit
+// word takes one or two bytes instead of four.
+void ReplayBuffer::putSnapshot(const Snapshot& snapshot) {
+	uint32_t words[SNAPSHOT_WORDS];
+	memcpy(words, &snapshot, sizeof(Snapshot));
+	for (int i = 0; i < SNAPSHOT_WORDS; i++)
+		putVarint(zigzag((int32_t) words[i]));
+}
+
+ReplayRecorder::ReplayRecorder(long seed, int hashInterval, int keyframeInterval) {
+	this->hashInterval = hashInterval;
+	this->keyframeInterval = keyframeInterval;
+	run = 0;
+	ticks = 0;
+	start = -1;
+	stopped = false;
+	for (int i = 0; i < 4; i++)
+		buffer.putByte(REPLAY_MAGIC[i]);
+	buffer.putVarint(REPLAY_VERSION);
+	buffer.putVarint((uint32_t) seed);
+	buffer.putVarint(TICK_TIME);
+	buffer.putVarint(hashInterval);
+	buffer.putVarint(keyframeInterval);
+	buffer.putVarint(SNAPSHOT_WORDS);
+}
+
+void ReplayRecorder::flush() {
+	if (run > 0) {
+		buffer.putVarint(REPLAY_TICKS);
+		buffer.putVarint(run);
+		run = 0;
+	}
+}
+
+void ReplayRecorder::direction(int direction) {
+	if (stopped)
+		return;
+	flush();
+	buffer.putVarint(REPLAY_DIRECTION);
+	buffer.putVarint(direction);
+}
+
+// Called by WorldController before it runs a tick. Checks are spaced from
+// the first tick recorded, which always gets a keyframe. A level or spirit
+// count too large for a Snapshot stops the recording there for good, as a
+// replay cannot skip ticks; what came before is still saved.
+void ReplayRecorder::tick(WorldController* controller) {
+	if (stopped)
+		return;
+	long tick = controller->getTickCount();
+	if (start < 0)
+		start = tick;
+	bool keyframe = (tick - start) % keyframeInterval == 0;
+	if (keyframe || (tick - start) % hashInterval == 0) {
+		Snapshot snapshot;
+		if (!controller->snapshot(&snapshot)) {
+			LOGE("tick %ld does not fit in a snapshot; replay recording stopped", tick);
+			stopped = true;
+			return;
+		}
+		flush();
+		if (keyframe) {
+			buffer.putVarint(REPLAY_KEYFRAME);
+			buffer.putVarint(tick);
+			buffer.putSnapshot(snapshot);
+		} else {
+			buffer.putVarint(REPLAY_HASH);
+			buffer.putVarint(hashSnapshot(snapshot));
+		}
+	}
+	run++;
+	ticks++;
+}
+
+bool ReplayRecorder::save(const char* path) {
+	if (ticks == 0) {
+		LOGW("no ticks recorded for %s", path);
+		return false;
+	}
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) {
+		LOGW("cannot write replay %s", path);
+		return false;
+	}
+	flush();
+	int size = buffer.size();
+	buffer.putVarint(REPLAY_END);
+	buffer.putVarint(ticks);
+	bool written = fwrite(buffer.data(), 1, buffer.size(), file) == (size_t) buffer.size();
+	// Drop the trailer again so recording can go on after a save.
+	buffer.truncate(size);
+	fclose(file);
+	return written;
+}
+
+ReplayPlayer::ReplayPlayer() {
+	data = NULL;
+	size = 0;
+	offset = 0;
+	headerEnd = 0;
+	seed = 0;
+	ticks = 0;
+	run = 0;
+	divergences = 0;
+	firstDivergence = -1;
+}
+
+ReplayPlayer::~ReplayPlayer() {
+	free(data);
+}
+
+bool ReplayPlayer::load(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		LOGW("cannot read replay %s", path);
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t* bytes = (uint8_t*) malloc(length > 0 ? length : 1);
+	bool read = fread(bytes, 1, length, file) == (size_t) length;
+	fclose(file);
+	bool loaded = read && load(bytes, (int) length);
+	free(bytes);
+	return loaded;
+}
+
+bool ReplayPlayer::load(const uint8_t* bytes, int length) {
+	free(data);
+	data = (uint8_t*) malloc(length > 0 ? length : 1);
+	memcpy(data, bytes, length);
+	size = length;
+	offset = 0;
+	keyframeOffsets.clear();
+	keyframeTicks.clear();
+	if (size < 4 || memcmp(data, REPLAY_MAGIC, 4) != 0) {
+		LOGW("not a replay");
+		return false;
+	}
+	offset = 4;
+	uint32_t version, value, tickTime, hashInterval, keyframeInterval, words;
+	if (!readVarint(&version) || version != REPLAY_VERSION || !readVarint(&value)
+			|| !readVarint(&tickTime) || tickTime != (uint32_t) TICK_TIME
+			|| !readVarint(&hashInterval) || !readVarint(&keyframeInterval)
+			|| !readVarint(&words) || words != (uint32_t) SNAPSHOT_WORDS) {
+		LOGW("unsupported replay version");
+		return false;
+	}
+	seed = value;
+	headerEnd = offset;
+	return index();
+}
+
+bool ReplayPlayer::readVarint(uint32_t* value) {
+	uint32_t result = 0;
+	for (int shift = 0; shift < 35 && offset < size; shift += 7) {
+		uint8_t byte = data[offset++];
+		result |= (uint32_t) (byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ReplayPlayer::readSnapshot(Snapshot* snapshot) {
+	uint32_t words[SNAPSHOT_WORDS];
+	for (int i = 0; i < SNAPSHOT_WORDS; i++) {
+		uint32_t value;
+		if (!readVarint(&value))
+			return false;
+		words[i] = (uint32_t) unzigzag(value);
+	}
+	memcpy(snapshot, words, sizeof(Snapshot));
+	return true;
+}
+
+// One pass over the stream to find the keyframes and the length in ticks.
+bool ReplayPlayer::index() {
+	long tick = 0;
+	uint32_t record, value;
+	Snapshot snapshot;
+	offset = headerEnd;
+	ticks = -1;
+	while (offset < size && readVarint(&record)) {
+		switch (record) {
+		case REPLAY_TICKS:
+			if (!readVarint(&value))
+				return false;
+			if (keyframeTicks.size() == 0) {
+				LOGW("replay has no starting keyframe");
+				return false;
+			}
+			tick += value;
+			break;
+		case REPLAY_DIRECTION:
+			if (!readVarint(&value))
+				return false;
+			if (!isDirection(value)) {
+				LOGW("bad replay direction %u at tick %ld", value, tick);
+				return false;
+			}
+			break;
+		case REPLAY_HASH:
+			if (!readVarint(&value))
+				return false;
+			break;
+		case REPLAY_KEYFRAME:
+			if (!readVarint(&value))
+				return false;
+			keyframeTicks.append(value);
+			keyframeOffsets.append(offset);
+			if (!readSnapshot(&snapshot))
+				return false;
+			tick = value;
+			break;
+		case REPLAY_END:
+			if (!readVarint(&value))
+				return false;
+			ticks = value;
+			break;
+		default:
+			LOGW("bad replay record %u", record);
+			return false;
+		}
+	}
+	if (keyframeTicks.size() == 0) {
+		LOGW("replay has no starting keyframe");
+		return false;
+	}
+	if (ticks < 0)
+		ticks = tick - keyframeTicks.get(0); // recording cut short, play what there is
+	return true;
+}
+
+// Puts the controller's world in the recorded starting state.
+bool ReplayPlayer::start(WorldController* controller) {
+	srand48(seed);
+	divergences = 0;
+	firstDivergence = -1;
+	return seek(controller, getStartTick());
+}
+
+void ReplayPlayer::check(WorldController* controller, uint32_t hash, long tick) {
+	Snapshot snapshot;
+	controller->snapshot(&snapshot);
+	if (hashSnapshot(snapshot) != hash)
+		diverged(tick);
+}
+
+void ReplayPlayer::diverged(long tick) {
+	if (divergences++ == 0) {
+		firstDivergence = tick;
+		LOGW("replay diverged at tick %ld", tick);
+	}
+}
+
+void ReplayPlayer::step(WorldController* controller) {
+	controller->tick();
+}
+
+// Runs up to count recorded ticks; returns how many ran.
+long ReplayPlayer::play(WorldController* controller, long count) {
+	long done = 0;
+	uint32_t record, value;
+	Snapshot snapshot;
+	while (done < count) {
+		if (run > 0) {
+			long n = run < count - done ? run : count - done;
+			for (long i = 0; i < n; i++)
+				step(controller);
+			run -= n;
+			done += n;
+			continue;
+		}
+		if (offset >= size || !readVarint(&record))
+			break;
+		if (record == REPLAY_END)
+			break;
+		if (record == REPLAY_KEYFRAME) {
+			if (!readVarint(&value) || !readSnapshot(&snapshot))
+				break;
+			check(controller, hashSnapshot(snapshot), value);
+			continue;
+		}
+		if (!readVarint(&value))
+			break;
+		switch (record) {
+		case REPLAY_TICKS:
+			run = value;
+			break;
+		case REPLAY_DIRECTION:
+			// index() turned these away; a stream changed since then plays
+			// on without the turn, as a replay that no longer matches
+			if (isDirection(value))
+				controller->setDirection(value);
+			else
+				diverged(controller->getTickCount());
+			break;
+		case REPLAY_HASH:
+			check(controller, value, controller->getTickCount());
+			break;
+		}
+	}
+	return done;
+}
+
+// Restores the last keyframe at or before tick and plays forward from it,
+// so the cost is bounded by the keyframe interval.
+bool ReplayPlayer::seek(WorldController* controller, long tick) {
+	int found = -1;
+	for (int i = 0; i < keyframeTicks.size() && keyframeTicks.get(i) <= tick; i++)
+		found = i;
+	if (found < 0)
+		return false;
+	Snapshot snapshot;
+	offset = keyframeOffsets.get(found);
+	run = 0;
+	if (!readSnapshot(&snapshot) || !controller->restore(snapshot))
+		return false;
+	long remaining = tick - keyframeTicks.get(found);
+	return play(controller, remaining) == remaining;
+}
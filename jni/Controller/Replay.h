@@ -0,0 +1,109 @@
+#ifndef Replay_H_
+#define Replay_H_
+
+#include <stdint.h>
+#include "model/Snapshot.h"
+#include "templates/list.h"
+
+class WorldController;
+class World;
+
+// Replay file: a header, then a stream of varint records.
+//
+//   "PRPL" version seed tickTime hashInterval keyframeInterval snapshotWords
+//   REPLAY_TICKS n            n ticks with no input between them
+//   REPLAY_DIRECTION d        swipe made before the next tick
+//   REPLAY_HASH h             state hash before tick t, (t - t0) % hashInterval == 0
+//   REPLAY_KEYFRAME t words   full Snapshot before tick t, zigzag varints
+//   REPLAY_END ticks
+//
+// t0 is the tick of the first keyframe, which comes before any tick run: a
+// game resumed from a snapshot is recorded from the tick it resumed at.
+// Hash and keyframe records always start a new tick run, so a run never
+// straddles a check and playback can resume right after any keyframe.
+// Ticks only mean the same time in a build with the same TICK_TIME, so a
+// replay plays back only there.
+
+static const int REPLAY_VERSION = 3;
+
+enum ReplayRecord {
+	REPLAY_END,
+	REPLAY_TICKS,
+	REPLAY_DIRECTION,
+	REPLAY_HASH,
+	REPLAY_KEYFRAME,
+};
+
+class ReplayBuffer {
+public:
+	ReplayBuffer();
+	~ReplayBuffer();
+	void putByte(uint8_t value);
+	void putVarint(uint32_t value);
+	void putSnapshot(const Snapshot& snapshot);
+	const uint8_t* data() const {return bytes;}
+	int size() const {return count;}
+	void truncate(int size) {if (size < count) count = size;}
+private:
+	uint8_t* bytes;
+	int count;
+	int capacity;
+	ReplayBuffer(const ReplayBuffer&);
+	ReplayBuffer& operator=(const ReplayBuffer&);
+};
+
+class ReplayRecorder {
+public:
+	ReplayRecorder(long seed, int hashInterval = 100, int keyframeInterval = 1000);
+	void direction(int direction);
+	void tick(WorldController* controller);
+	bool save(const char* path);
+	int size() {return buffer.size();}
+	// False once a check could not be taken; see tick().
+	bool isRecording() {return !stopped;}
+private:
+	ReplayBuffer buffer;
+	int hashInterval;
+	int keyframeInterval;
+	long run;
+	long ticks;
+	long start;	// tick of the first keyframe, or -1 before the first tick
+	bool stopped;
+	void flush();
+};
+
+class ReplayPlayer {
+public:
+	ReplayPlayer();
+	~ReplayPlayer();
+	bool load(const char* path);
+	bool load(const uint8_t* data, int size);
+	long getSeed() {return seed;}
+	long getTicks() {return ticks;} // recorded, counting from getStartTick()
+	long getStartTick() {return keyframeTicks.size() ? keyframeTicks.get(0) : 0;}
+	long getDivergences() {return divergences;}
+	long getFirstDivergence() {return firstDivergence;}
+	bool start(WorldController* controller);
+	long play(WorldController* controller, long count);
+	bool seek(WorldController* controller, long tick);
+private:
+	uint8_t* data;
+	int size;
+	int offset;
+	int headerEnd;
+	long seed;
+	long ticks;
+	long run;
+	long divergences;
+	long firstDivergence;
+	List<int> keyframeOffsets;
+	List<long> keyframeTicks;
+	bool readVarint(uint32_t* value);
+	bool readSnapshot(Snapshot* snapshot);
+	bool index();
+	void check(WorldController* controller, uint32_t hash, long tick);
+	void diverged(long tick);
+	void step(WorldController* controller);
+};
+
+#endif /* Replay_H_ */
@@ -0,0 +1,41 @@
+#include "Controller/RewindBuffer.h"
+#include "Controller/WorldController.h"
+
+RewindBuffer::RewindBuffer(int capacity) {
+	this->capacity = capacity > 0 ? capacity : 1;
+	snapshots = new Snapshot[this->capacity];
+	head = 0;
+	count = 0;
+	failing = false;
+}
+
+RewindBuffer::~RewindBuffer() {
+	delete[] snapshots;
+}
+
+void RewindBuffer::push(WorldController* controller) {
+	if (!controller->snapshot(&snapshots[head])) {
+		if (!failing)
+			LOGW("tick %ld does not fit in a snapshot; rewind history dropped", controller->getTickCount());
+		failing = true;
+		count = 0;
+		return;
+	}
+	failing = false;
+	head = (head + 1) % capacity;
+	if (count < capacity)
+		count++;
+}
+
+// Restores the state from before the ticks-th most recent tick, dropping
+// everything newer; fails without changes if the ring is not that deep.
+bool RewindBuffer::rewind(WorldController* controller, int ticks) {
+	if (ticks <= 0 || ticks > count)
+		return false;
+	int index = (head - ticks + capacity) % capacity;
+	if (!controller->restore(snapshots[index]))
+		return false;
+	head = index;
+	count -= ticks;
+	return true;
+}
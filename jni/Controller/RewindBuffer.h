@@ -0,0 +1,30 @@
+#ifndef RewindBuffer_H_
+#define RewindBuffer_H_
+
+#include "model/Snapshot.h"
+
+class WorldController;
+
+// Ring of the most recent per-tick snapshots. Attached to a WorldController
+// it is filled before every tick, and rewind() steps the game back. A tick
+// too large for a Snapshot empties the ring, since rewinding past it would
+// skip over the ticks in between; it fills again once ticks fit.
+class RewindBuffer {
+public:
+	RewindBuffer(int capacity);
+	~RewindBuffer();
+	void push(WorldController* controller);
+	bool rewind(WorldController* controller, int ticks);
+	int size() {return count;}
+	int getCapacity() {return capacity;}
+private:
+	Snapshot* snapshots;
+	int capacity;
+	int head;
+	int count;
+	bool failing; // the last push could not take a snapshot
+	RewindBuffer(const RewindBuffer&);
+	RewindBuffer& operator=(const RewindBuffer&);
+};
+
+#endif /* RewindBuffer_H_ */
@@ -34,8 +34,9 @@ SoundController::~SoundController(){
 }
 
 void SoundController::play(){
-	if(world->eatPoint())eatPoint->play(false);//TODO bug won't play first sound
-	if(world->eatBonus())eatBonus->play(false);
-	if(world->deadSpirit())eatSpirit->play(false);
-	if(world->deadPlayer())deadPlayer->play(false);
+	const EventBuffer& events = world->getEvents();
+	if(events.contains(PELLET_EATEN))eatPoint->play(false);//TODO bug won't play first sound
+	if(events.contains(BONUS_EATEN))eatBonus->play(false);
+	if(events.contains(SPIRIT_EATEN))eatSpirit->play(false);
+	if(events.contains(PLAYER_DIED))deadPlayer->play(false);
 }
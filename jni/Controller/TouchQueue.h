@@ -0,0 +1,58 @@
+#ifndef TouchQueue_H_
+#define TouchQueue_H_
+
+#include <stdint.h>
+
+struct TouchEvent {
+	int action;		// TOUCH_DOWN, TOUCH_MOVE or TOUCH_UP
+	int x;
+	int y;
+	uint64_t stamp;	// monotonicNanos() when it came in, or 0
+};
+
+// Touches on their way from the UI thread, which reports them, to the game
+// thread, which acts on them at the start of its next tick; everything the
+// controller holds is then only ever touched by the game thread. One
+// thread pushes and the other pops, so each index has a single writer and
+// a barrier on either side of the slot copy is all the locking needed.
+class TouchQueue {
+public:
+	static const int CAPACITY = 64;
+
+	TouchQueue() : head(0), tail(0) {}
+	// UI thread. Fails, dropping the touch, if the game thread has fallen
+	// CAPACITY - 1 touches behind.
+	bool push(const TouchEvent& event) {
+		int next = (tail + 1) % CAPACITY;
+		if (next == head)
+			return false;
+		events[tail] = event;
+		__sync_synchronize();
+		tail = next;
+		return true;
+	}
+	// Game thread.
+	bool pop(TouchEvent* event) {
+		if (head == tail)
+			return false;
+		__sync_synchronize();
+		*event = events[head];
+		__sync_synchronize();
+		head = (head + 1) % CAPACITY;
+		return true;
+	}
+	// Game thread. Drops every touch pushed so far.
+	void drain() {
+		head = tail;
+		__sync_synchronize();
+	}
+
+private:
+	TouchEvent events[CAPACITY];
+	volatile int head;	// written by the game thread only
+	volatile int tail;	// written by the UI thread only
+	TouchQueue(const TouchQueue&);
+	TouchQueue& operator=(const TouchQueue&);
+};
+
+#endif /* TouchQueue_H_ */
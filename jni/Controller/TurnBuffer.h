@@ -0,0 +1,40 @@
+#ifndef TurnBuffer_H_
+#define TurnBuffer_H_
+
+#include <stdint.h>
+
+// The player's latest swipe, held until the maze lets the player turn that
+// way or window ticks have gone by. A new swipe replaces the one held.
+// Each is stamped with the first tick that could apply it, so the ticks it
+// waited are known when it is taken. The clock time the touch came in
+// rides along for latency figures; it is not game state, so snapshots
+// leave it out. Only the game thread uses it: swipes from the UI thread
+// reach it through WorldController's TouchQueue, drained as a tick starts.
+class TurnBuffer {
+public:
+	int window; // ticks a swipe is held past its first
+
+	TurnBuffer() : window(0), direction(0), tick(0), stamp(0) {}
+	void push(int direction, long tick, uint64_t stamp = 0) {
+		this->direction = direction;
+		this->tick = tick;
+		this->stamp = stamp;
+	}
+	// Direction waiting to be taken on tick, or 0 if none is.
+	int pending(long tick) {
+		if (direction && tick - this->tick > window)
+			direction = 0;
+		return direction;
+	}
+	int getDirection() const { return direction; }
+	long getTick() const { return tick; }
+	uint64_t getStamp() const { return stamp; }
+	void clear() { direction = 0; }
+
+private:
+	int direction;
+	long tick;
+	uint64_t stamp;
+};
+
+#endif /* TurnBuffer_H_ */
@@ -1,82 +1,251 @@
 #include "WorldController.h"
-
-WorldController::WorldController(World* _world,WorldRenderer* worldRenderer) {
-	this->worldRenderer = worldRenderer;
+#include <stdlib.h>
+#include <string.h>
+#include "Controller/Replay.h"
+#include "Controller/RewindBuffer.h"
+#include "Controller/LevelLoader.h"
+#include "Controller/InputLatency.h"
+
+WorldController::WorldController(World* _world) {
 	this->world = _world;
-	this->worldRenderer->setWorld(world);
-	direction = LEFT;
+	recorder = NULL;
+	rewind = NULL;
+	loader = NULL;
+	latency = NULL;
+	touches = NULL;
+	turns.window = TURN_WINDOW_TICKS;
+	touchDirection = 0;
+	accumulator = 0;
+	tickCount = 0;
+	second = 0;
+	leftTime = false;
+	leftDefenceSpirit = false;
 }
 
 void WorldController::startGame() {
 
 }
 
-void WorldController::onPause() {
-
+// Saves the game to path so it survives the process being killed.
+bool WorldController::onPause(const char* path) {
+	Snapshot snapshot;
+	return this->snapshot(&snapshot) && writeSnapshot(path, snapshot);
 }
 
-void WorldController::onResume() {
-
+// Continues the game saved by onPause, if there is one for this level.
+bool WorldController::onResume(const char* path) {
+	Snapshot snapshot;
+	return readSnapshot(path, &snapshot) && restore(snapshot);
 }
 
-void WorldController::setSound(bool isSound) {
+void WorldController::setSound(bool) {
 
 }
 
 void WorldController::newGame() {
 	world->createSpirit();
 	world->startPointPlayer();
-	world->leftSpirit =3;
+	world->leftSpirit = world->spirits.size() - 1;
 }
 
 void WorldController::actionPerformedSpirit(bool isDefence) {
-		for(int i=0; i < world->spirits->size() - world->leftSpirit; i++){
-			if(world->spirits->get(i)->getState() == DEFENCE)
-				world->spirits->get(i)->setDefence(isDefence);
-			world->spirits->get(i)->go(world);
+		Movers& spirits = world->spirits;
+		for(int i=0; i < spirits.size() - world->leftSpirit; i++){
+			if(spirits.state[i] == DEFENCE)
+				spirits.white[i] = isDefence;
+			Spirit::go(world, i);
+		}
+}
+
+int WorldController::update(double elapsedTime) {
+	accumulator += elapsedTime;
+	int ticks = (int) (accumulator / TICK_TIME);
+	accumulator -= ticks * TICK_TIME;
+	return ticks;
+}
+
+void WorldController::tick() {
+	TouchEvent touch;
+	while (touches && touches->pop(&touch))
+		onTouch(touch.action, touch.x, touch.y, touch.stamp);
+	if (recorder)
+		recorder->tick(this);
+	if (rewind)
+		rewind->push(this);
+	world->beginTick();
+	tickCount++;
+	actionPerformedSpirit(leftDefenceSpirit);
+	if (world->getPlayer()->getState() == ATTACK) {
+		leftTime = true;
+	}
+	actionPerformed();
+	if (tickCount % BONUS_TICKS == 0) {
+		timeBonus();
+	}
+	world->resolveContacts();
+	if (loader) {
+		if (world->getEvents().contains(LEVEL_CLEARED))
+			openNextLevel();
+		else if (world->getCountPoint() <= PRELOAD_POINTS)
+			loader->preload(world->getLevelNumber() + 1);
+	}
+}
+
+void WorldController::timeBonus() {
+	if (world->leftSpirit > 0)
+		world->leftSpirit--;
+	if (leftTime) {
+		second++;
+		if (second >= 8 && second % 2 == 0) {
+			leftDefenceSpirit = true;
+		} else {
+			leftDefenceSpirit = false;
+		}
+
+		if (second >= 12) {
+			world->attackNPC();
+			leftDefenceSpirit = false;
+			second = 0;
+			leftTime = false;
 		}
+	}
 }
 
+// Moves the player, turning it if a held swipe allows; a swipe is used up
+// once the player heads its way. Only a swipe that actually turned the
+// player counts towards the latency, not one along the current heading.
 void WorldController::actionPerformed() {
-	world->tryToPlayerGo(direction);
+	int waited = tickCount - turns.getTick();
+	if (world->tryToPlayerGo(turns.pending(tickCount), waited)) {
+		if (latency && world->getEvents().contains(PLAYER_TURNED))
+			latency->turned(tickCount, waited, turns.getStamp(), monotonicNanos());
+		turns.clear();
+	}
 	if(world->getPlayer()->getState() == DEAD){
 		newGame();
 	}
 }
 
-void WorldController::setScore(int score) {
+void WorldController::setScore(int) {
+
+}
 
+// A cleared level that is followed by one that cannot be loaded is played
+// again rather than left empty: nothing would ever clear it a second time.
+void WorldController::openNextLevel() {
+	if (!openLevel(world->getLevelNumber() + 1)) {
+		world->restartLevel();
+		resetClocks();
+	}
 }
 
-void WorldController::nextLevel(int level, int record) {
+// Swaps in level number, normally preloaded by now, and starts it with the
+// clocks reset. The world is repointed rather than rebuilt, so the swap
+// fits in a tick. On failure the current level is left as it was.
+bool WorldController::openLevel(int number) {
+	Level* level = loader->take(number);
+	if (level == NULL) {
+		LOGE("cannot open level %d", number);
+		return false;
+	}
+	world->loadLevel(level);
+	resetClocks();
+	return true;
+}
 
+void WorldController::resetClocks() {
+	turns.clear();
+	second = 0;
+	leftTime = false;
+	leftDefenceSpirit = false;
 }
 
-void WorldController::onTouch(int ACTION, int x, int y) {
+// Everything the next tick depends on, including the world; zero-filled
+// first so equal states hash equally.
+bool WorldController::snapshot(Snapshot* snapshot) {
+	memset(snapshot, 0, sizeof(Snapshot));
+	snapshot->tick = tickCount;
+	snapshot->turn = turns.getDirection();
+	snapshot->turnTick = turns.getTick();
+	snapshot->turnWindow = turns.window;
+	snapshot->second = second;
+	snapshot->leftTime = leftTime;
+	snapshot->leftDefenceSpirit = leftDefenceSpirit;
+	return world->snapshot(snapshot);
+}
+
+// Puts the game back as snapshot left it, switching level if need be.
+// Fails, changing nothing, on a snapshot no level here could take.
+bool WorldController::restore(const Snapshot& snapshot) {
+	if (snapshot.turn != 0 && !isDirection(snapshot.turn))
+		return false;
+	if (snapshot.level != world->getLevelNumber()) {
+		// Checked against the other level before it replaces this one.
+		const Level* level = loader ? loader->peek(snapshot.level) : NULL;
+		if (level == NULL || !world->canRestore(snapshot, level)
+				|| !openLevel(snapshot.level))
+			return false;
+	}
+	if (!world->restore(snapshot))
+		return false;
+	tickCount = snapshot.tick;
+	turns.push(snapshot.turn, snapshot.turnTick);
+	turns.window = snapshot.turnWindow;
+	second = snapshot.second;
+	leftTime = snapshot.leftTime != 0;
+	leftDefenceSpirit = snapshot.leftDefenceSpirit != 0;
+	return true;
+}
+
+// A swipe is held for the next ticks; see TurnBuffer. Each touch swipes
+// once per change of direction, however many moves it reports. stamp is
+// the monotonicNanos() the touch came in at, if known. Runs on the thread
+// that ticks, between ticks, so turns and replay records land on the tick
+// boundary; touches from another thread come in through touches.
+void WorldController::onTouch(int ACTION, int x, int y, uint64_t stamp) {
+	int swiped = 0;
 	switch (ACTION) {
 	case TOUCH_DOWN:
 		touchX = x;
 		touchY = y;
+		touchDirection = 0;
 		break;
 	case TOUCH_MOVE:
 		if (touchX > x && abs(x - touchX) > 20 && abs(y - touchY) < 60)
-			direction = LEFT;
+			swiped = LEFT;
 		if (touchX < x && abs(x - touchX) > 20 && abs(y - touchY) < 60)
-			direction = RIGHT;
+			swiped = RIGHT;
 		if (touchY > y && abs(y - touchY) > 20 && abs(x - touchX) < 60)
-			direction = UP;
+			swiped = UP;
 		if (touchY < y && abs(y - touchY) > 20 && abs(x - touchX) < 60)
-			direction = DOWN;
+			swiped = DOWN;
 		break;
 	case TOUCH_UP:
 		if (touchX > x && abs(y - touchY) < 60)
-			direction = LEFT;
+			swiped = LEFT;
 		if (touchX < x && abs(y - touchY) < 60)
-			direction = RIGHT;
+			swiped = RIGHT;
 		if (touchY > y && abs(x - touchX) < 60)
-			direction = UP;
+			swiped = UP;
 		if (touchY < y && abs(x - touchX) < 60)
-			direction = DOWN;
+			swiped = DOWN;
 		break;
 	}
+	if (swiped && swiped != touchDirection) {
+		touchDirection = swiped;
+		setDirection(swiped, stamp);
+	}
+}
+
+// Holds a turn for the player from the next tick on. Unstamped turns, as
+// replays give, are taken to arrive now. Anything but one of the four
+// headings is ignored: the player would stand still on it for good.
+void WorldController::setDirection(int direction, uint64_t stamp) {
+	if (!isDirection(direction))
+		return;
+	if (latency && stamp == 0)
+		stamp = monotonicNanos();
+	turns.push(direction, tickCount + 1, stamp);
+	if (recorder)
+		recorder->direction(direction);
 }
@@ -1,13 +1,34 @@
 #ifndef WorldController_H_
 #define WorldController_H_
 
-#include "View/WorldRenderer.h"
 #include "model/ActionTouch.h"
 #include "model/World.h"
+#include "model/Snapshot.h"
+#include "Controller/TurnBuffer.h"
+#include "Controller/TouchQueue.h"
 
+// Game clocks, counted in fixed simulation ticks of TICK_TIME ms. Movers
+// step every tick by the distance their speed covers in one (see Speed.h).
+static const int TICK_TIME = PACMAN_TICK_TIME;
+static const int BONUS_TICKS = 1000 / TICK_TIME;
+// How long a swipe waits for the maze to allow its turn by default.
+static const int TURN_WINDOW_TICKS = 500 / TICK_TIME;
+// Points left when the next level starts loading in the background.
+static const int PRELOAD_POINTS = 30;
+
+class ReplayRecorder;
+class RewindBuffer;
+class InputLatency;
+class LevelLoader;
 class WorldController {
 private:
-	int direction;
+	TurnBuffer turns;
+	double accumulator;
+	long tickCount;
+	int second;
+	bool leftTime;
+	bool leftDefenceSpirit;
+	void timeBonus();
 //     World world;
 //     GameLogic logic;
 //     Timer mainTimer;
@@ -15,25 +36,36 @@ private:
 //     MainActivity mainActivity;
 	int touchX;
 	int touchY;
+	int touchDirection; // last swipe made by the touch in progress, or 0
 	void newGame();
+	bool openLevel(int number);
+	void resetClocks();
 public:
-	WorldController(World* world, WorldRenderer* worldRenderer);
+	WorldController(World* world);
 	~WorldController(){
 		LOGI("WorldController::~WorldController");
-		delete worldRenderer;
-		LOGI("WorldController::~WorldController finished");
 	};
-	WorldRenderer* worldRenderer;
 	World* world;
+	ReplayRecorder* recorder; // told of every direction change and tick, or NULL
+	RewindBuffer* rewind; // given a snapshot before every tick, or NULL
+	LevelLoader* loader; // brings in the next level on clear, or NULL to stay
+	InputLatency* latency; // told of every turn taken, or NULL
+	TouchQueue* touches; // drained into onTouch at the start of every tick, or NULL
 	void startGame();
-	void onTouch(int ACTION, int x, int y);
-	void onPause();
-	void onResume();
+	void onTouch(int ACTION, int x, int y, uint64_t stamp = 0);
+	bool onPause(const char* path);
+	bool onResume(const char* path);
 	void setSound(bool isSound);
 	void actionPerformed();
 	void actionPerformedSpirit(bool isDefence);
+	int update(double elapsedTime);
+	void tick();
+	long getTickCount(){return tickCount;}
+	void setDirection(int direction, uint64_t stamp = 0);
+	void setTurnWindow(int ticks){turns.window = ticks;}
+	bool snapshot(Snapshot* snapshot);
+	bool restore(const Snapshot& snapshot);
 	void setScore(int score);
 	void openNextLevel();
-	void nextLevel(int level, int record);
 };
 #endif /* WorldController_H_ */
@@ -0,0 +1,122 @@
+#include "MazeMesh.h"
+#include <string.h>
+
+static const int layerTextures[] = {background, point, bonus};
+
+MazeMesh::MazeMesh() : rangeCount(0), quadCount(0), changedCount(0),
+		rebuilt(false), levelNumber(-1), width(0), layerFirst(0), layerSize(0) {
+}
+
+// Reads the world's pellet bitsets directly.
+int MazeMesh::layerOf(World* world, int cell){
+	if (levelBit(world->getPellets(), cell))
+		return LAYER_POINT;
+	if (levelBit(world->getPower(), cell))
+		return LAYER_BONUS;
+	return LAYER_BACKGROUND;
+}
+
+static bool isStatic(int tile){
+	return tile == TILE_WALL || tile == TILE_DOOR;
+}
+
+// Same corners and texture coordinates as the renderer's unrotated quad.
+void MazeMesh::setQuad(int quad, float x, float y, bool visible){
+	float size = visible ? BRICK_SIZE : 0;
+	float* v = vertices.data() + quad * QUAD_FLOATS;
+	v[0] = x;         v[1] = y;         v[2] = 0;  v[3] = 0;
+	v[4] = x + size;  v[5] = y;         v[6] = 1;  v[7] = 0;
+	v[8] = x + size;  v[9] = y + size;  v[10] = 1; v[11] = 1;
+	v[12] = x;        v[13] = y + size; v[14] = 0; v[15] = 1;
+}
+
+void MazeMesh::build(World* world){
+	levelNumber = world->getLevelNumber();
+	width = world->getWidth();
+	int cells = width * world->getHeight();
+
+	int walls = 0;
+	for(int i=0; i < cells; i++){
+		if (isStatic(world->getTile(i % width, i / width)))
+			walls++;
+	}
+	layerFirst = walls;
+	layerSize = cells - walls;
+	quadCount = walls + LAYERS * layerSize;
+	vertices.resize(quadCount * QUAD_FLOATS);
+	slot.resize(cells);
+	shown.resize(cells);
+	changed.resize(2 * layerSize);
+	changedCount = 0;
+
+	// Walls sorted by texture so each texture is one range.
+	rangeCount = 0;
+	int quad = 0;
+	for(int texture=0; texture < TEXTURES_COUNT; texture++){
+		int first = quad;
+		for(int i=0; i < cells; i++){
+			if (!isStatic(world->getTile(i % width, i / width))
+					|| world->getTexture(i) != texture)
+				continue;
+			setQuad(quad++, (i % width) * BRICK_SIZE, (i / width) * BRICK_SIZE, true);
+		}
+		if (quad > first) {
+			MazeRange range = {texture, first, quad - first};
+			ranges[rangeCount++] = range;
+		}
+	}
+
+	int next = 0;
+	for(int i=0; i < cells; i++){
+		int tile = world->getTile(i % width, i / width);
+		if (isStatic(tile)) {
+			slot[i] = -1;
+			continue;
+		}
+		slot[i] = next++;
+		shown[i] = layerOf(world, i);
+		for(int layer=0; layer < LAYERS; layer++){
+			setQuad(layerFirst + layer * layerSize + slot[i],
+					(i % width) * BRICK_SIZE, (i / width) * BRICK_SIZE, layer == shown[i]);
+		}
+	}
+	for(int layer=0; layer < LAYERS; layer++){
+		MazeRange range = {layerTextures[layer], layerFirst + layer * layerSize, layerSize};
+		ranges[rangeCount++] = range;
+	}
+	world->clearDirtyTiles();
+}
+
+void MazeMesh::show(int cell, int layer){
+	if (slot[cell] < 0 || shown[cell] == layer)
+		return;
+	int hidden = layerFirst + shown[cell] * layerSize + slot[cell];
+	int visible = layerFirst + layer * layerSize + slot[cell];
+	const float* corner = vertices.data() + hidden * QUAD_FLOATS;
+	float x = corner[0], y = corner[1];
+	setQuad(hidden, x, y, false);
+	setQuad(visible, x, y, true);
+	changed[changedCount++] = hidden;
+	changed[changedCount++] = visible;
+	shown[cell] = layer;
+}
+
+// Applies the tiles World flagged since the last call and clears the flags.
+// Returns the number of quads that need uploading: the changed ones, or all
+// of them when the world has moved on to another level.
+int MazeMesh::update(World* world){
+	changedCount = 0;
+	rebuilt = world->getLevelNumber() != levelNumber;
+	if (rebuilt) {
+		build(world);
+		return quadCount;
+	}
+	if (world->getDirtyCount() == 0)
+		return 0;
+	const int* dirty = world->getDirtyCells();
+	for(int i=0; i < world->getDirtyCount(); i++){
+		show(dirty[i], layerOf(world, dirty[i]));
+	}
+	world->clearDirtyTiles();
+	return changedCount;
+}
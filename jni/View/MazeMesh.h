@@ -0,0 +1,62 @@
+#ifndef MazeMesh_H_
+#define MazeMesh_H_
+
+#include "model/World.h"
+#include "templates/AlignedArray.h"
+
+// A run of quads in the maze vertex buffer drawn with one texture.
+struct MazeRange {
+	int texture;
+	int first;
+	int count;
+};
+
+// CPU side of the maze vertex buffer, kept apart from GL so host builds can
+// measure it. Walls and doors are written once. Every walkable cell has one
+// quad in each of the background, point and bonus runs, and only the one
+// matching its tile has any area; the others are collapsed to a point. A
+// tile change therefore rewrites two quads and leaves the rest of the buffer
+// as it was on the GPU.
+class MazeMesh {
+public:
+	static const int VERTEX_FLOATS = 4;  // x, y, u, v
+	static const int QUAD_FLOATS = 4 * VERTEX_FLOATS;
+	static const int QUAD_BYTES = QUAD_FLOATS * sizeof(float);
+
+	MazeMesh();
+	void build(World* world);
+	int update(World* world);
+	const float* getVertices(){return vertices.data();}
+	int getQuadCount(){return quadCount;}
+	int getRangeCount(){return rangeCount;}
+	const MazeRange& getRange(int i){return ranges[i];}
+	// Quads rewritten by the last update(), to be uploaded in this order.
+	int getChangedCount(){return changedCount;}
+	int getChanged(int i){return changed[i];}
+	// Whether the last update() rebuilt the whole mesh for a new level.
+	bool isRebuilt(){return rebuilt;}
+
+private:
+	enum { LAYER_BACKGROUND, LAYER_POINT, LAYER_BONUS, LAYERS };
+	static const int MAX_RANGES = TEXTURES_COUNT + LAYERS;
+
+	AlignedArray<float> vertices;
+	AlignedArray<int> slot;
+	AlignedArray<uint8_t> shown;
+	AlignedArray<int> changed;
+	MazeRange ranges[MAX_RANGES];
+	int rangeCount;
+	int quadCount;
+	int changedCount;
+	bool rebuilt;
+	int levelNumber;
+	int width;
+	int layerFirst;
+	int layerSize;
+
+	static int layerOf(World* world, int cell);
+	void setQuad(int quad, float x, float y, bool visible);
+	void show(int cell, int layer);
+};
+
+#endif /* MazeMesh_H_ */
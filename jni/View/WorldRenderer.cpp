@@ -32,16 +32,12 @@ void WorldRenderer::render(){
 	checkGlError("glClear");
 
 	if(art->isCreateTexture == true){
-	for(int i=0; i < world->bricks->size()-1; i++){
-		draw(world->bricks->get(i)->getTexture(),
-				world->bricks->get(i)->getPosition()->getX(),
-				world->bricks->get(i)->getPosition()->getY());
-	}
-	for(int i=0; i < world->spirits->size(); i++){
-		draw(world->spirits->get(i)->getTexture(),world->spirits->get(i)->getPosition()->getX(), world->spirits->get(i)->getPosition()->getY());
+	drawMaze();
+	for(int i=0; i < world->spirits.size(); i++){
+		draw(world->spirits.texture[i], fixedToPixels(world->spirits.x[i]), fixedToPixels(world->spirits.y[i]));
 	}
 	world->getPlayer()->animate();
-	draw(world->getPlayer()->getTexture(), world->getPlayer()->getPosition()->getX(),world->getPlayer()->getPosition()->getY());
+	draw(world->getPlayer()->getTexture(), world->getPlayer()->getPosition().getX(),world->getPlayer()->getPosition().getY());
 	}
 	glUseProgram(art->stableProgram);
 
@@ -133,6 +129,8 @@ void WorldRenderer::create(GLuint _shiftProgram, Art* _art){
 }
 WorldRenderer::~WorldRenderer() {
 	LOGI("WorldRenderer::~WorldRenderer");
+	glDeleteBuffers(1, &mazeBufferId);
+	glDeleteBuffers(1, &mazeIndicesBufferId);
 	delete art;
 	delete world;
 	LOGI("WorldRenderer::~WorldRenderer finished");
@@ -204,4 +202,81 @@ void WorldRenderer::initGraphics(Art* _art){
 
 void WorldRenderer::setWorld(World* world){
 	this->world = world;
+	createMaze();
+}
+
+// The maze lives in one vertex buffer uploaded here; afterwards render()
+// only sends the quads of tiles that changed.
+void WorldRenderer::createMaze(){
+	maze.build(world);
+
+	GLushort* indicesData = new GLushort[MAZE_BATCH * 6];
+	for(int i = 0; i < MAZE_BATCH; ++i){
+		GLushort first = i * 4;
+		indicesData[i*6 + 0] = first;
+		indicesData[i*6 + 1] = first + 1;
+		indicesData[i*6 + 2] = first + 2;
+		indicesData[i*6 + 3] = first + 2;
+		indicesData[i*6 + 4] = first + 3;
+		indicesData[i*6 + 5] = first;
+	}
+
+	glGenBuffers(1, &mazeBufferId);
+	checkGlError("glGenBuffers(1, &mazeBufferId);");
+	glGenBuffers(1, &mazeIndicesBufferId);
+	checkGlError("glGenBuffers(1, &mazeIndicesBufferId);");
+
+	glBindBuffer(GL_ARRAY_BUFFER, mazeBufferId);
+	glBufferData(GL_ARRAY_BUFFER, maze.getQuadCount() * MazeMesh::QUAD_BYTES, maze.getVertices(), GL_DYNAMIC_DRAW);
+	checkGlError("glBufferData(GL_ARRAY_BUFFER, maze)");
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mazeIndicesBufferId);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAZE_BATCH * 6 * sizeof(GLushort), indicesData, GL_STATIC_DRAW);
+	checkGlError("glBufferData(GL_ELEMENT_ARRAY_BUFFER, maze)");
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	delete[] indicesData;
+}
+
+void WorldRenderer::drawMaze(){
+	glUseProgram(shiftProgram);
+	glUniform2f(shiftHandle, 0, 0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, mazeBufferId);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mazeIndicesBufferId);
+
+	maze.update(world);
+	if(maze.isRebuilt())
+		glBufferData(GL_ARRAY_BUFFER, maze.getQuadCount() * MazeMesh::QUAD_BYTES, maze.getVertices(), GL_DYNAMIC_DRAW);
+	for(int i = 0; i < maze.getChangedCount(); ++i){
+		int quad = maze.getChanged(i);
+		glBufferSubData(GL_ARRAY_BUFFER, quad * MazeMesh::QUAD_BYTES, MazeMesh::QUAD_BYTES,
+				maze.getVertices() + quad * MazeMesh::QUAD_FLOATS);
+	}
+
+	//x, y, tx, ty
+	GLsizei stride = MazeMesh::VERTEX_FLOATS * sizeof(GLfloat);
+	glEnableVertexAttribArray(shiftVertexHandle);
+	glEnableVertexAttribArray(shiftTextureHandle);
+
+	for(int i = 0; i < maze.getRangeCount(); ++i){
+		const MazeRange& range = maze.getRange(i);
+		glBindTexture(GL_TEXTURE_2D, art->getTexture(range.texture));
+		for(int first = range.first; first < range.first + range.count; first += MAZE_BATCH){
+			int count = range.first + range.count - first;
+			if(count > MAZE_BATCH)
+				count = MAZE_BATCH;
+			char* offset = (char*)0 + first * MazeMesh::QUAD_BYTES;
+			glVertexAttribPointer(shiftVertexHandle, 2, GL_FLOAT, GL_FALSE, stride, offset);
+			glVertexAttribPointer(shiftTextureHandle, 2, GL_FLOAT, GL_FALSE, stride, offset + 2 * sizeof(GLfloat));
+			glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, 0);
+		}
+	}
+
+	glDisableVertexAttribArray(shiftTextureHandle);
+	glDisableVertexAttribArray(shiftVertexHandle);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
@@ -5,6 +5,7 @@
 
 #include "Art.h"
 #include "model/World.h"
+#include "MazeMesh.h"
 #include "templates/list.h"
 
 class WorldRenderer{
@@ -18,6 +19,8 @@ public:
 	void render();
 	void load();
 	void draw(int _texture, GLfloat shiftX, GLfloat shiftY);
+	void createMaze();
+	void drawMaze();
 	void create(GLuint _shiftProgram, Art* _art);
 	Art* art;
 	World* world;
@@ -32,6 +35,11 @@ public:
 
 	GLuint verticesBufferId, indicesBufferId;
 
+	// Quads per glDrawElements, the most a GLushort index can address.
+	static const int MAZE_BATCH = 16384;
+	MazeMesh maze;
+	GLuint mazeBufferId, mazeIndicesBufferId;
+
 };
 
 #endif /* WorldRenderer_H_ */
@@ -0,0 +1,51 @@
+#include "host/HostAssetManager.h"
+
+#include <string.h>
+
+struct AAssetManager {
+	char root[256];
+};
+
+struct AAsset {
+	FILE* file;
+	off_t length;
+};
+
+AAssetManager* AAssetManager_fromDirectory(const char* root) {
+	AAssetManager* mgr = new AAssetManager();
+	strncpy(mgr->root, root, sizeof(mgr->root) - 1);
+	mgr->root[sizeof(mgr->root) - 1] = '\0';
+	return mgr;
+}
+
+void AAssetManager_delete(AAssetManager* mgr) {
+	delete mgr;
+}
+
+// Assets are always read whole from disk, so mode makes no difference.
+AAsset* AAssetManager_open(AAssetManager* mgr, const char* filename, int) {
+	char path[512];
+	snprintf(path, sizeof(path), "%s/%s", mgr->root, filename);
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+	AAsset* asset = new AAsset();
+	asset->file = file;
+	fseek(file, 0, SEEK_END);
+	asset->length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	return asset;
+}
+
+int AAsset_read(AAsset* asset, void* buf, size_t count) {
+	return (int) fread(buf, 1, count, asset->file);
+}
+
+off_t AAsset_getLength(AAsset* asset) {
+	return asset->length;
+}
+
+void AAsset_close(AAsset* asset) {
+	fclose(asset->file);
+	delete asset;
+}
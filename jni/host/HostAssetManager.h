@@ -0,0 +1,28 @@
+#ifndef HostAssetManager_H_
+#define HostAssetManager_H_
+
+#include <stdio.h>
+#include <sys/types.h>
+
+// The subset of the NDK asset API AAssetFile needs, served from a directory
+// on disk so host builds read the same assets/ tree the APK packages.
+
+struct AAssetManager;
+struct AAsset;
+
+enum {
+	AASSET_MODE_UNKNOWN = 0,
+	AASSET_MODE_RANDOM = 1,
+	AASSET_MODE_STREAMING = 2,
+	AASSET_MODE_BUFFER = 3
+};
+
+AAssetManager* AAssetManager_fromDirectory(const char* root);
+void AAssetManager_delete(AAssetManager* mgr);
+
+AAsset* AAssetManager_open(AAssetManager* mgr, const char* filename, int mode);
+int AAsset_read(AAsset* asset, void* buf, size_t count);
+off_t AAsset_getLength(AAsset* asset);
+void AAsset_close(AAsset* asset);
+
+#endif /* HostAssetManager_H_ */
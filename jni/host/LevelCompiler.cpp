@@ -0,0 +1,190 @@
+#include "host/LevelCompiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "model/LevelBlob.h"
+#include "model/Tile.h"
+#include "View/ETexture.h"
+
+struct CellCode {
+	int code;
+	int tile;
+	int texture;
+};
+
+// Empty cells (code 0) start with a point, so the blob holds the level
+// exactly as play begins.
+static const CellCode codes[] = {
+	{ 0, TILE_POINT, point },
+	{ 1, TILE_POINT, point },
+	{ 2, TILE_WALL, horizontal },
+	{ 3, TILE_WALL, vertical },
+	{ 4, TILE_WALL, angle_lv },
+	{ 5, TILE_WALL, angle_rv },
+	{ 6, TILE_WALL, angle_rd },
+	{ 7, TILE_WALL, angle_ld },
+	{ 8, TILE_WALL, arc_down },
+	{ 9, TILE_WALL, arc_left },
+	{ 10, TILE_WALL, arc_right },
+	{ 11, TILE_WALL, arc_up },
+	{ 12, TILE_WALL, arc2_down },
+	{ 13, TILE_WALL, arc2_right },
+	{ 14, TILE_WALL, arc2_left },
+	{ 15, TILE_WALL, arc2_up },
+	{ 16, TILE_BONUS, bonus },
+	{ 90, TILE_DOOR, none },	// Blinky's spawn
+	{ 91, TILE_DOOR, none },	// Pinky's spawn
+	{ 92, TILE_DOOR, none },	// Clyde's spawn
+	{ 93, TILE_DOOR, none },	// Inky's spawn
+	{ 94, TILE_POINT, point },	// the player's start
+	{ 99, TILE_DOOR, none },
+};
+
+static const int CODE_COUNT = sizeof(codes) / sizeof(codes[0]);
+
+// Start cells, indexed by their code - 90.
+enum LevelStart { START_BLINKY, START_PINKY, START_CLYDE, START_INKY, START_PLAYER, STARTS };
+
+static const CellCode* findCode(int code) {
+	for (int i = 0; i < CODE_COUNT; i++)
+		if (codes[i].code == code)
+			return &codes[i];
+	return NULL;
+}
+
+static void setBit(uint32_t* bits, int index) {
+	bits[index >> 5] |= 1u << (index & 31);
+}
+
+static void start(int32_t* cell, int index, int width) {
+	cell[0] = index % width;
+	cell[1] = index / width;
+}
+
+// Fills a zero-filled blob laid out by layoutLevel().
+static bool compile(const char* text, uint8_t* blob, int width, int height) {
+	LevelHeader* header = (LevelHeader*) blob;
+	uint8_t* tiles = blob + header->tiles;
+	uint8_t* textures = blob + header->textures;
+	uint32_t* pellets = (uint32_t*) (blob + header->pellets);
+	uint32_t* power = (uint32_t*) (blob + header->power);
+	uint32_t* walkable = (uint32_t*) (blob + header->walkable);
+	int32_t* starts[STARTS] = { header->blinky, header->pinky, header->clyde, header->inky, header->player };
+	bool started[STARTS] = { false, false, false, false, false };
+
+	int cells = width * height;
+	int count = 0;
+	const char* token = text;
+	for (;;) {
+		char* end;
+		long value = strtol(token, &end, 10);
+		if (end == token)
+			break;
+		token = end;
+		if (count == cells) {
+			fprintf(stderr, "more than %d cells\n", cells);
+			return false;
+		}
+		const CellCode* code = findCode(value);
+		if (code == NULL) {
+			fprintf(stderr, "unknown cell code %ld at cell %d\n", value, count);
+			return false;
+		}
+		int x = count % width;
+		int y = count / width;
+		if (code->tile != TILE_WALL && (x == 0 || y == 0 || x == width - 1 || y == height - 1)) {
+			fprintf(stderr, "open cell %ld on the border at (%d, %d)\n", value, x, y);
+			return false;
+		}
+		tiles[count] = code->tile;
+		textures[count] = code->texture;
+		if (code->tile == TILE_POINT)
+			setBit(pellets, count);
+		if (code->tile == TILE_BONUS)
+			setBit(power, count);
+		if (code->tile != TILE_WALL)
+			setBit(walkable, count);
+		if (code->code >= 90 && code->code < 90 + STARTS) {
+			start(starts[code->code - 90], count, width);
+			started[code->code - 90] = true;
+		}
+		count++;
+	}
+	while (*token == ' ' || *token == '\t' || *token == '\r' || *token == '\n')
+		token++;
+	if (*token) {
+		fprintf(stderr, "unexpected '%c' after cell %d\n", *token, count);
+		return false;
+	}
+	if (count != cells) {
+		fprintf(stderr, "%d cells, expected %dx%d\n", count, width, height);
+		return false;
+	}
+	for (int i = 0; i < STARTS; i++) {
+		if (!started[i]) {
+			fprintf(stderr, "missing start cell (code %d)\n", 90 + i);
+			return false;
+		}
+	}
+	return true;
+}
+
+uint8_t* compileLevel(const char* text, int width, int height, uint32_t* size) {
+	if (width <= 0 || width > LEVEL_MAX_SIDE || height <= 0 || height > LEVEL_MAX_SIDE) {
+		fprintf(stderr, "%dx%d is outside 1x1 to %dx%d\n", width, height, LEVEL_MAX_SIDE, LEVEL_MAX_SIDE);
+		return NULL;
+	}
+	LevelHeader layout;
+	layoutLevel(&layout, width, height);
+	// operator new[] storage is aligned for any scalar, as mapLevel() needs.
+	uint8_t* blob = new uint8_t[layout.size];
+	memset(blob, 0, layout.size);
+	memcpy(blob, &layout, sizeof(layout));
+	if (!compile(text, blob, width, height)) {
+		delete[] blob;
+		return NULL;
+	}
+	*size = layout.size;
+	return blob;
+}
+
+// Last odd index short of the border, where the lattice's corridors run.
+static int lastCorridor(int side) {
+	return (side - 2) % 2 ? side - 2 : side - 3;
+}
+
+char* generateLevel(int width, int height) {
+	if (width < LEVEL_MIN_GENERATED || height < LEVEL_MIN_GENERATED
+			|| width > LEVEL_MAX_SIDE || height > LEVEL_MAX_SIDE)
+		return NULL;
+	int* cells = new int[width * height];
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			bool border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+			cells[y * width + x] = border || (x % 2 == 0 && y % 2 == 0) ? 2 : 0;
+		}
+	}
+	// Odd rows are open from border to border.
+	int row = (height / 2) | 1;
+	int column = width / 2 - 1;
+	static const int spawns[4] = { 93, 92, 90, 91 };
+	for (int i = 0; i < 4; i++)
+		cells[row * width + column + i] = spawns[i];
+	cells[(row + 2) * width + column + 1] = 94;
+	int right = lastCorridor(width);
+	int bottom = lastCorridor(height);
+	cells[1 * width + 1] = 16;
+	cells[1 * width + right] = 16;
+	cells[bottom * width + 1] = 16;
+	cells[bottom * width + right] = 16;
+
+	// Up to three digits and a separator per cell.
+	char* text = new char[width * height * 4 + 1];
+	char* out = text;
+	for (int i = 0; i < width * height; i++)
+		out += sprintf(out, "%d%c", cells[i], (i + 1) % width ? ' ' : '\n');
+	delete[] cells;
+	return text;
+}
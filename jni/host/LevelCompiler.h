@@ -0,0 +1,24 @@
+#ifndef LevelCompiler_H_
+#define LevelCompiler_H_
+
+#include <stdint.h>
+
+// Host-side level building shared by pacman_levelc and pacman_bench.
+//
+// A text map is whitespace-separated cell codes, row-major. Codes 90-93
+// mark the spirits' spawn doors and 94 the player's start; every cell on
+// the border must be a wall.
+
+// Compiles text into a new[]-allocated, 4-byte aligned blob of *size bytes
+// that mapLevel() accepts, or returns NULL after printing why to stderr.
+uint8_t* compileLevel(const char* text, int width, int height, uint32_t* size);
+
+// A text map of the given size, new[]-allocated, for benchmarking: a
+// lattice of single-cell pillars, so every corridor crosses every other,
+// with the spawns and the player's start near the middle and a bonus in
+// each corner. Returns NULL if the size is under LEVEL_MIN_GENERATED.
+char* generateLevel(int width, int height);
+
+static const int LEVEL_MIN_GENERATED = 9;
+
+#endif /* LevelCompiler_H_ */
@@ -0,0 +1,595 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <malloc.h>
+#include <new>
+
+#include "log.h"
+#include "host/HostAssetManager.h"
+#include "model/ActionTouch.h"
+#include "model/World.h"
+#include "model/ReadLevel.h"
+#include "Controller/WorldController.h"
+#include "Controller/Replay.h"
+#include "Controller/RewindBuffer.h"
+#include "Controller/LevelLoader.h"
+#include "host/LevelCompiler.h"
+
+#ifndef PACMAN_ASSETS_DIR
+#define PACMAN_ASSETS_DIR "assets"
+#endif
+
+// Headless tick benchmark. Each scenario builds a fresh World, swipes in a
+// seeded random direction every SWIPE_TICKS and runs WorldController::tick,
+// which steps spirits and player as the game does. Reports ticks per
+// second, per-tick latency percentiles and heap allocations per tick, one
+// line per scenario.
+//
+//   pacman_bench [-t ticks] [-s scenario] [-r seed] [-g ghosts] [--scale]
+//                [-m WIDTHxHEIGHT] [--mazes] [--dynamic] [--no-nav] [--rewind]
+//                [assets-dir]
+//   pacman_bench --soak deaths [-r seed] [assets-dir]
+//   pacman_bench --tiles [-t ticks] [-r seed] [-m WIDTHxHEIGHT] [assets-dir]
+//   pacman_bench --flood [-m WIDTHxHEIGHT] [assets-dir]
+//
+// -g plays with that many spirits, taking the four behaviours in turn.
+// --scale runs every chosen scenario at each of SCALE_GHOSTS instead, and
+// on every tick also checks each spirit against the others through the
+// contact grid, reporting the touching pairs. -m plays a maze generated
+// at that size (see host/LevelCompiler.h) instead of the first level in the
+// assets; --mazes runs every chosen scenario on each of BENCH_MAZES.
+// --dynamic plays 25x15 mazes on the dynamic-size kernels rather than the
+// ones specialised for that size, for comparison (the grid column says
+// which ran).
+// --rewind keeps a snapshot of every tick in a ten-second ring, as a rewind
+// feature would; mazes over SNAPSHOT_CELLS take none, and say so once.
+//
+// --soak plays the chase scenario through the level pack, levels preloaded
+// as in the game, until the player has died that many times, and reports
+// the heap in use after each death: it should not grow.
+//
+// --tiles plays the chase scenario and, on every tick, puts the wall and
+// door questions the movers ask to both the tile grid (collidesWithLevel,
+// collidesWithRefresh) and a scan of one brick per cell, as the game
+// answered them before the grid. It reports each side's time per tick and
+// any answers that differ, which should be none.
+//
+// --flood checks the spirits' flood (FloodMap) against the 40-sweep
+// potential map it replaced, for every open spirit cell, heading (or none,
+// as when DEAD), target cell and minimum depth the spirits use. It compares
+// what the spirits read: the spirit's label, the direction findDirection
+// would take, and every cell up to the minimum depth. Cases where the old
+// map left the spirit's cell or an open neighbour unlabelled are counted
+// apart, as the old answer there was an artefact of its step cap.
+
+static const int SWIPE_TICKS = 500;
+static const int REWIND_TICKS = 1000;
+// Turning this often keeps the player roaming into the spirits.
+static const int SOAK_SWIPE_TICKS = 50;
+static const int SCALE_GHOSTS[] = { 4, 16, 64, 256, 1024 };
+static const int SCALE_COUNT = sizeof(SCALE_GHOSTS) / sizeof(SCALE_GHOSTS[0]);
+// The benchmark level set: the shipped maze's size and two far larger.
+static const int BENCH_MAZES[][2] = { { 25, 15 }, { 128, 128 }, { 1024, 1024 } };
+static const int MAZE_COUNT = sizeof(BENCH_MAZES) / sizeof(BENCH_MAZES[0]);
+
+// Heap allocations made by this process; only the timed loop is reported.
+static long allocations = 0;
+// Bytes of heap held through operator new; the level loader's thread
+// allocates too, hence the atomic updates.
+static long heapBytes = 0;
+
+// Frees what operator new took. Kept out of line: once GCC has inlined
+// both operators into a caller it sees new's result reach free() and
+// reports a mismatched pair (-Wmismatched-new-delete).
+static void __attribute__((noinline)) release(void* p) {
+	if (p)
+		__sync_fetch_and_sub(&heapBytes, (long) malloc_usable_size(p));
+	free(p);
+}
+
+void* operator new(size_t size) {
+	allocations++;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	__sync_fetch_and_add(&heapBytes, (long) malloc_usable_size(p));
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) throw() {
+	release(p);
+}
+
+void operator delete[](void* p) throw() {
+	operator delete(p);
+}
+
+void operator delete(void* p, size_t) throw() {
+	release(p);
+}
+
+void operator delete[](void* p, size_t) throw() {
+	operator delete(p);
+}
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int compareLatency(const void* a, const void* b) {
+	uint32_t x = *(const uint32_t*) a;
+	uint32_t y = *(const uint32_t*) b;
+	return x < y ? -1 : x > y;
+}
+
+// Scenario hooks run before every tick to hold the world in the state
+// being measured.
+
+static void chase(World*) {
+}
+
+static void released(World* world) {
+	world->leftSpirit = 0;
+}
+
+// Frightened mode as eatBonus starts it, renewed whenever timeBonus ends it.
+static void frightened(World* world) {
+	world->leftSpirit = 0;
+	if (world->getPlayer()->getState() != ATTACK) {
+		world->getPlayer()->setState(ATTACK);
+		world->defenceNPC();
+	}
+}
+
+// All spirits are eaten again once the last one has reached home.
+static void returning(World* world) {
+	world->leftSpirit = 0;
+	for (int i = 0; i < world->spirits.size(); i++)
+		if (world->spirits.state[i] == DEAD)
+			return;
+	for (int i = 0; i < world->spirits.size(); i++)
+		world->spirits.state[i] = DEAD;
+}
+
+struct Scenario {
+	const char* name;
+	void (*prepare)(World* world);
+};
+
+static const Scenario scenarios[] = {
+	{ "chase", chase },
+	{ "released", released },
+	{ "frightened", frightened },
+	{ "returning", returning },
+};
+
+static const int SCENARIO_COUNT = sizeof(scenarios) / sizeof(scenarios[0]);
+
+static void swipe(WorldController* controller, int direction) {
+	int x = 300, y = 300;
+	switch (direction) {
+	case LEFT:  x -= 100; break;
+	case RIGHT: x += 100; break;
+	case UP:    y -= 100; break;
+	case DOWN:  y += 100; break;
+	}
+	controller->onTouch(TOUCH_DOWN, 300, 300);
+	controller->onTouch(TOUCH_UP, x, y);
+}
+
+// Touching pairs among the spirits, each counted once.
+static long spiritPairs(World* world, int* ids) {
+	long pairs = 0;
+	for (int i = 0; i < world->spirits.size(); i++) {
+		int count = world->touchingSpirits(Spirit::bounds(world->spirits, i), ids);
+		for (int k = 0; k < count; k++)
+			if (ids[k] > i)
+				pairs++;
+	}
+	return pairs;
+}
+
+// The pre-grid collision test: every brick's bounds against rect. The
+// bricks carry the cell's Tile kind as their texture.
+static bool scanBricks(List<Brick>& bricks, Rectangle rect, int kind) {
+	for (int i = 0; i < bricks.size(); i++)
+		if (bricks[i].getTexture() == kind && bricks[i].getBounds().intersects(rect))
+			return true;
+	return false;
+}
+
+// The potential map as it was before FloodMap: the wall map, target 1,
+// the cell behind the spirit walled off, then 40 sweeps of the grid each
+// labelling the neighbours of the last step's cells. Its edge tests are
+// kept as they were.
+static const int OLD_FLOOD_SWEEPS = 40;
+
+static void oldFlood(const int* walls, int width, int height, int target, int back, int* map) {
+	memcpy(map, walls, width * height * sizeof(int));
+	map[target] = 1;
+	if (back >= 0)
+		map[back] = FLOOD_WALL;
+	int step = 2;
+	for (int count = 0; count < OLD_FLOOD_SWEEPS; count++, step++) {
+		for (int row = 0; row < width; row++) {
+			for (int column = 0; column < height; column++) {
+				int index = column * width + row;
+				if (map[index] != step - 1)
+					continue;
+				if (row > 1 && map[index - 1] == 0)
+					map[index - 1] = step;
+				if (row < width - 1 && map[index + 1] == 0)
+					map[index + 1] = step;
+				if (column > 1 && map[index - width] == 0)
+					map[index - width] = step;
+				if (column < height - 1 && map[index + width] == 0)
+					map[index + width] = step;
+			}
+		}
+	}
+}
+
+// The direction findDirection takes from the labels around own; labels
+// are passed in LEFT, RIGHT, UP, DOWN order.
+static int floodDirection(int step, const int* around) {
+	static const int directions[] = { LEFT, RIGHT, UP, DOWN };
+	int direction = 0;
+	for (int i = 0; i < 4; i++)
+		if (around[i] < step + 1)
+			direction = directions[i];
+	return direction;
+}
+
+// Compiles a generated maze into readLevel's level.
+static bool loadGenerated(ReadLevel* readLevel, int width, int height) {
+	char* text = generateLevel(width, height);
+	if (text == NULL)
+		return false;
+	uint32_t size;
+	uint8_t* blob = compileLevel(text, width, height, &size);
+	delete[] text;
+	if (blob == NULL)
+		return false;
+	memcpy(readLevel->newBlob(readLevel->level, size), blob, size);
+	delete[] blob;
+	return readLevel->prepareLevel(0, "generated", readLevel->level);
+}
+
+static bool run(const Scenario& scenario, AAssetManager* assetManager, const int* maze, long ticks,
+		long seed, int ghosts, bool pairs, bool navigation, bool specialise, RewindBuffer* rewind,
+		uint32_t* latency) {
+	ReadLevel readLevel(assetManager);
+	readLevel.navigation = navigation;
+	readLevel.specialise = specialise;
+	if (maze ? !loadGenerated(&readLevel, maze[0], maze[1]) : !readLevel.loadLevels())
+		return false;
+	World* world = new World(readLevel.level, ghosts);
+	int* ids = new int[ghosts];
+	long touching = 0;
+	WorldController* worldController = new WorldController(world);
+	worldController->rewind = rewind;
+	static const int directions[] = { LEFT, RIGHT, UP, DOWN };
+	srand48(seed);
+
+	long allocationsBefore = allocations;
+	uint64_t start = now();
+	for (long i = 0; i < ticks; i++) {
+		uint64_t begin = now();
+		if (i % SWIPE_TICKS == 0)
+			swipe(worldController, directions[lrand48() % 4]);
+		scenario.prepare(world);
+		worldController->tick();
+		if (pairs)
+			touching += spiritPairs(world, ids);
+		latency[i] = (uint32_t) (now() - begin);
+	}
+	uint64_t elapsed = now() - start;
+	long allocated = allocations - allocationsBefore;
+
+	qsort(latency, ticks, sizeof(uint32_t), compareLatency);
+	printf("%-10s %4dx%-4d %-7s %4d ghosts %10ld ticks %12.0f ticks/s  p50 %6u ns  p99 %6u ns  max %8u ns  %.6f allocs/tick",
+			scenario.name, world->getWidth(), world->getHeight(), world->isStandard() ? "static" : "dynamic", ghosts, ticks, ticks * 1e9 / elapsed, latency[ticks / 2],
+			latency[ticks - 1 - ticks / 100], latency[ticks - 1], (double) allocated / ticks);
+	if (pairs)
+		printf("  %.1f pairs/tick", (double) touching / ticks);
+	printf("\n");
+
+	delete[] ids;
+	delete worldController;
+	delete world;
+	return true;
+}
+
+static bool tiles(AAssetManager* assetManager, const int* maze, long ticks, long seed, uint32_t* latency) {
+	ReadLevel readLevel(assetManager);
+	if (maze ? !loadGenerated(&readLevel, maze[0], maze[1]) : !readLevel.loadLevels())
+		return false;
+	World* world = new World(readLevel.level);
+	WorldController* worldController = new WorldController(world);
+	List<Brick> bricks;
+	bricks.reserve(world->getWidth() * world->getHeight());
+	for (int y = 0; y < world->getHeight(); y++)
+		for (int x = 0; x < world->getWidth(); x++)
+			bricks.append(Brick(Point(x, y), world->getTile(x, y),
+					BRICK_SIZE, BRICK_SIZE));
+	static const int directions[] = { LEFT, RIGHT, UP, DOWN };
+	srand48(seed);
+
+	// Spirits and player as the tile queries see them, refilled each tick.
+	int movers = world->spirits.size() + 1;
+	Rectangle* rects = new Rectangle[movers];
+	uint32_t* scanLatency = new uint32_t[ticks];
+	long queries = 0, mismatches = 0;
+	uint64_t scanTotal = 0, gridTotal = 0;
+	for (long i = 0; i < ticks; i++) {
+		if (i % SWIPE_TICKS == 0)
+			swipe(worldController, directions[lrand48() % 4]);
+		worldController->tick();
+		for (int k = 0; k < movers - 1; k++)
+			rects[k] = Spirit::bounds(world->spirits, k);
+		rects[movers - 1] = world->getPlayer()->getBounds();
+		int scanned = 0, found = 0;
+		uint64_t begin = now();
+		for (int k = 0; k < movers; k++)
+			scanned += scanBricks(bricks, rects[k], TILE_WALL) + 2 * scanBricks(bricks, rects[k], TILE_DOOR);
+		uint64_t middle = now();
+		for (int k = 0; k < movers; k++)
+			found += world->collidesWithLevel(rects[k]) + 2 * (world->collidesWithRefresh(rects[k]) == ATTACK);
+		uint64_t end = now();
+		if (scanned != found)
+			mismatches++;
+		queries += 2 * movers;
+		scanLatency[i] = (uint32_t) (middle - begin);
+		latency[i] = (uint32_t) (end - middle);
+		scanTotal += middle - begin;
+		gridTotal += end - middle;
+	}
+	qsort(scanLatency, ticks, sizeof(uint32_t), compareLatency);
+	qsort(latency, ticks, sizeof(uint32_t), compareLatency);
+	printf("tiles %4dx%-4d %10ld ticks %ld queries: brick scan p50 %6u ns/tick mean %8.1f, tile grid p50 %6u ns/tick mean %8.1f, "
+			"%ld ticks differ\n", world->getWidth(), world->getHeight(), ticks, queries,
+			scanLatency[ticks / 2], (double) scanTotal / ticks, latency[ticks / 2], (double) gridTotal / ticks,
+			mismatches);
+
+	delete[] scanLatency;
+	delete[] rects;
+	delete worldController;
+	delete world;
+	return true;
+}
+
+// False if the level would not load or any case differs.
+static bool floods(AAssetManager* assetManager, const int* maze) {
+	ReadLevel readLevel(assetManager);
+	if (maze ? !loadGenerated(&readLevel, maze[0], maze[1]) : !readLevel.loadLevels()) {
+		LOGE("cannot load levels");
+		return false;
+	}
+	World* world = new World(readLevel.level);
+	int width = world->getWidth();
+	int height = world->getHeight();
+	int cells = width * height;
+	const int* walls = world->getWallMap();
+	FloodMap flood;
+	flood.reset(walls, width, height, world->isStandard());
+	int* old = new int[cells];
+	// Headings, the last standing for none; and the minimum depths of
+	// findDirection, Inky and Pinky.
+	static const int headings[] = { LEFT, RIGHT, UP, DOWN, 0 };
+	static const int minSteps[] = { 0, 3, 5 };
+
+	long cases = 0, capped = 0, differ = 0;
+	uint64_t oldTime = 0, newTime = 0;
+	for (int own = 0; own < cells; own++) {
+		int x = own % width, y = own / width;
+		if (walls[own] || x == 0 || y == 0 || x == width - 1 || y == height - 1)
+			continue;
+		for (int h = 0; h < 5; h++) {
+			int back = -1;
+			switch (headings[h]) {
+			case LEFT:  back = own + 1; break;
+			case RIGHT: back = own - 1; break;
+			case UP:    back = own + width; break;
+			case DOWN:  back = own - width; break;
+			}
+			for (int target = 0; target < cells; target++) {
+				if (walls[target])
+					continue;
+				uint64_t begin = now();
+				oldFlood(walls, width, height, target, back, old);
+				oldTime += now() - begin;
+				int oldAround[] = { old[own - 1], old[own + 1], old[own - width], old[own + width] };
+				for (int m = 0; m < 3; m++) {
+					int minStep = minSteps[m];
+					begin = now();
+					flood.clear();
+					flood.set(target, 1);
+					if (back >= 0)
+						flood.set(back, FLOOD_WALL);
+					flood.flood(target, own, minStep);
+					newTime += now() - begin;
+					cases++;
+					if (old[own] == 0 || !oldAround[0] || !oldAround[1] || !oldAround[2] || !oldAround[3]) {
+						capped++;
+						continue;
+					}
+					int newAround[] = { flood.at(own - 1), flood.at(own + 1), flood.at(own - width),
+							flood.at(own + width) };
+					bool same = flood.at(own) == old[own]
+							&& floodDirection(old[own], oldAround) == floodDirection(flood.at(own), newAround);
+					for (int cell = 0; cell < cells && same && minStep; cell++)
+						if (old[cell] <= minStep && old[cell] != flood.within(cell, minStep))
+							same = false;
+					if (!same)
+						differ++;
+				}
+			}
+		}
+	}
+	printf("flood %4dx%-4d %ld cases, %ld beyond the old step cap, %ld differ; old sweep %.0f ns, "
+			"FloodMap %.0f ns per flood\n", width, height, cases, capped, differ,
+			(double) oldTime * 3 / cases, (double) newTime / cases);
+
+	delete[] old;
+	delete world;
+	return differ == 0;
+}
+
+// Plays until the player has died deaths times. The first death's heap
+// is the baseline, as by then every buffer a level needs has been sized.
+static bool soak(AAssetManager* assetManager, long deaths, long seed) {
+	ReadLevel readLevel(assetManager);
+	if (!readLevel.loadLevels())
+		return false;
+	World* world = new World(readLevel.level);
+	WorldController* worldController = new WorldController(world);
+	LevelLoader* levelLoader = new LevelLoader(&readLevel);
+	worldController->loader = levelLoader;
+	static const int directions[] = { LEFT, RIGHT, UP, DOWN };
+	srand48(seed);
+
+	long died = 0, cleared = 0, ticks = 0;
+	long first = 0, last = 0, most = 0;
+	while (died < deaths) {
+		if (ticks++ % SOAK_SWIPE_TICKS == 0)
+			swipe(worldController, directions[lrand48() % 4]);
+		worldController->tick();
+		const EventBuffer& events = world->getEvents();
+		if (events.contains(LEVEL_CLEARED))
+			cleared++;
+		if (events.contains(PLAYER_DIED)) {
+			if (died++ == 0)
+				first = heapBytes;
+			last = heapBytes;
+			if (heapBytes > most)
+				most = heapBytes;
+		}
+	}
+	printf("soak: %ld deaths, %ld levels cleared in %ld ticks; heap after first death %ld bytes, "
+			"after last %ld, most %ld\n", died, cleared, ticks, first, last, most);
+
+	delete worldController;
+	delete world;
+	delete levelLoader;
+	return true;
+}
+
+int main(int argc, char** argv) {
+	const char* assetsDir = PACMAN_ASSETS_DIR;
+	const char* only = NULL;
+	long ticks = 1000000;
+	long seed = 1;
+	bool navigation = true;
+	bool rewind = false;
+	int ghosts = 4;
+	bool scale = false;
+	int maze[2] = { 0, 0 };
+	bool mazes = false;
+	bool specialise = true;
+	long deaths = 0;
+	bool tileQueries = false;
+	bool floodCheck = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			ticks = atol(argv[++i]);
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			only = argv[++i];
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			seed = atol(argv[++i]);
+		else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+			ghosts = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--scale") == 0)
+			scale = true;
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &maze[0], &maze[1]) == 2)
+			i++;
+		else if (strcmp(argv[i], "--mazes") == 0)
+			mazes = true;
+		else if (strcmp(argv[i], "--dynamic") == 0)
+			specialise = false;
+		else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc)
+			deaths = atol(argv[++i]);
+		else if (strcmp(argv[i], "--tiles") == 0)
+			tileQueries = true;
+		else if (strcmp(argv[i], "--flood") == 0)
+			floodCheck = true;
+		else if (strcmp(argv[i], "--no-nav") == 0)
+			navigation = false;
+		else if (strcmp(argv[i], "--rewind") == 0)
+			rewind = true;
+		else if (argv[i][0] == '-') {
+			fprintf(stderr, "usage: %s [-t ticks] [-s scenario] [-r seed] [-g ghosts] [--scale] [-m WIDTHxHEIGHT] [--mazes]\n"
+					"       [--dynamic] [--no-nav] [--rewind] [assets-dir]\n"
+					"       %s --soak deaths [-r seed] [assets-dir]\n"
+					"       %s --tiles [-t ticks] [-r seed] [-m WIDTHxHEIGHT] [assets-dir]\n"
+					"       %s --flood [-m WIDTHxHEIGHT] [assets-dir]\n", argv[0], argv[0], argv[0], argv[0]);
+			return 2;
+		} else
+			assetsDir = argv[i];
+	}
+	if (ticks <= 0)
+		ticks = 1;
+	if (ghosts < 1)
+		ghosts = 1;
+
+	AAssetManager* assetManager = AAssetManager_fromDirectory(assetsDir);
+	if (deaths > 0) {
+		int result = soak(assetManager, deaths, seed) ? 0 : 1;
+		if (result)
+			LOGE("cannot load levels from %s", assetsDir);
+		AAssetManager_delete(assetManager);
+		return result;
+	}
+	if (floodCheck) {
+		int result = floods(assetManager, maze[0] ? maze : NULL) ? 0 : 1;
+		AAssetManager_delete(assetManager);
+		return result;
+	}
+	uint32_t* latency = new uint32_t[ticks];
+	if (tileQueries) {
+		int result = tiles(assetManager, maze[0] ? maze : NULL, ticks, seed, latency) ? 0 : 1;
+		if (result)
+			LOGE("cannot load levels");
+		delete[] latency;
+		AAssetManager_delete(assetManager);
+		return result;
+	}
+	RewindBuffer* rewindBuffer = rewind ? new RewindBuffer(REWIND_TICKS) : NULL;
+	int result = 0;
+	bool found = false;
+	for (int i = 0; i < SCENARIO_COUNT; i++) {
+		if (only && strcmp(only, scenarios[i].name) != 0)
+			continue;
+		found = true;
+		for (int m = 0; m < (mazes ? MAZE_COUNT : 1) && result == 0; m++) {
+			const int* size = mazes ? BENCH_MAZES[m] : maze[0] ? maze : NULL;
+			for (int g = 0; g < (scale ? SCALE_COUNT : 1) && result == 0; g++) {
+				if (!run(scenarios[i], assetManager, size, ticks, seed, scale ? SCALE_GHOSTS[g] : ghosts, scale,
+						navigation, specialise, rewindBuffer, latency)) {
+					if (size)
+						LOGE("cannot generate a %dx%d maze", size[0], size[1]);
+					else
+						LOGE("cannot load levels from %s", assetsDir);
+					result = 1;
+				}
+			}
+		}
+		if (result)
+			break;
+	}
+	if (!found) {
+		LOGE("unknown scenario %s", only);
+		result = 2;
+	}
+	delete rewindBuffer;
+	delete[] latency;
+	AAssetManager_delete(assetManager);
+	return result;
+}
@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log.h"
+#include "host/HostAssetManager.h"
+#include "model/ActionTouch.h"
+#include "model/World.h"
+#include "model/ReadLevel.h"
+#include "Controller/WorldController.h"
+#include "Controller/Replay.h"
+#include "Controller/RewindBuffer.h"
+#include "Controller/LevelLoader.h"
+#include "Controller/InputLatency.h"
+#include "View/MazeMesh.h"
+
+#ifndef PACMAN_ASSETS_DIR
+#define PACMAN_ASSETS_DIR "assets"
+#endif
+
+// Headless game loop for host builds. Loads the level from an assets
+// directory on disk and either plays it with random swipes at a fixed tick
+// rate, optionally recording a replay, or plays a replay back.
+//
+//   pacman_cli [-t ticks] [-r seed] [-o out.rpl] [-l in.snp] [-w out.snp]
+//              [-b rewind-ticks] [-i turn-window-ms] [assets-dir]
+//   pacman_cli -p in.rpl [-s seek-tick | -c out.csv] [assets-dir]
+//
+// -l and -w resume from and pause to a snapshot file as the app does;
+// -b rewinds that many ticks at the end of the run; -i holds swipes that
+// long for their turn. Swipe-to-turn latency is reported in ticks. The maze vertex buffer
+// is kept up to date as the renderer would at a frame every FRAME_TICKS
+// ticks, and the bytes it would upload are reported.
+//
+// -c plays the replay a frame at a time and writes each turn's latency
+// stages (see InputLatency.h) to out.csv. There is no touch or GPU here,
+// so the figures are the simulation's and the maze upload's share only.
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Swipes go through a TouchQueue as the app's do, so the turn buffer is
+// fed at the start of the next tick.
+static void swipe(TouchQueue* touches, int direction) {
+	int x = 300, y = 300;
+	switch (direction) {
+	case LEFT:  x -= 100; break;
+	case RIGHT: x += 100; break;
+	case UP:    y -= 100; break;
+	case DOWN:  y += 100; break;
+	}
+	TouchEvent down = { TOUCH_DOWN, 300, 300, 0 };
+	TouchEvent up = { TOUCH_UP, x, y, 0 };
+	touches->push(down);
+	touches->push(up);
+}
+
+static const int FRAME_TICKS = 2;
+// Random swipes come every five seconds of play whatever the tick length.
+static const int SWIPE_TICKS = 5000 / TICK_TIME;
+// Turn latencies above this many ticks share the last histogram bucket.
+static const int LATENCY_BUCKETS = 256;
+
+static int countTiles(World* world, int kind) {
+	int count = 0;
+	for (int y = 0; y < world->getHeight(); y++)
+		for (int x = 0; x < world->getWidth(); x++)
+			if (world->getTile(x, y) == kind)
+				count++;
+	return count;
+}
+
+static void report(WorldController* controller) {
+	World* world = controller->world;
+	Snapshot snapshot;
+	controller->snapshot(&snapshot);
+	Point player = world->getPlayer()->getPosition();
+	printf("tick %ld, level %d, state hash %08x\n", controller->getTickCount(), world->getLevelNumber(),
+			hashSnapshot(snapshot));
+	printf("player at (%d, %d), state %d, lives %d\n", player.getX(), player.getY(),
+			world->getPlayer()->getState(), world->getPlayer()->getLife());
+	printf("points left %d, bonuses left %d\n", countTiles(world, TILE_POINT), countTiles(world, TILE_BONUS));
+}
+
+// Smallest latency with at least fraction of the turns at or under it.
+static int percentile(const long* histogram, long turns, double fraction) {
+	long seen = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; i++) {
+		seen += histogram[i];
+		if (seen > 0 && seen >= fraction * turns)
+			return i;
+	}
+	return LATENCY_BUCKETS - 1;
+}
+
+static void printLatency(const InputLatency& latency) {
+	static const char* names[LATENCY_STAGES] = { "input to tick", "tick to frame", "input to frame" };
+	printf("%ld turns over the last %d", latency.getTurns(), latency.size(INPUT_TO_TICK));
+	for (int stage = 0; stage < LATENCY_STAGES; stage++)
+		printf(", %s p50 %.1f p95 %.1f p99 %.1f us", names[stage], latency.percentile(stage, 0.5) / 1e3,
+				latency.percentile(stage, 0.95) / 1e3, latency.percentile(stage, 0.99) / 1e3);
+	printf("\n");
+}
+
+// Plays the replay out in frames of FRAME_TICKS, updating the maze buffer
+// for each as the renderer would, with every turn logged to csv.
+static long playFrames(WorldController* controller, ReplayPlayer* player, FILE* csv) {
+	InputLatency latency;
+	latency.setLog(csv);
+	controller->latency = &latency;
+	MazeMesh maze;
+	maze.build(controller->world);
+	long ticks = 0, played;
+	do {
+		played = player->play(controller, FRAME_TICKS);
+		ticks += played;
+		maze.update(controller->world);
+		latency.frame(monotonicNanos());
+	} while (played == FRAME_TICKS);
+	controller->latency = NULL;
+	printLatency(latency);
+	return ticks;
+}
+
+static int replay(WorldController* controller, const char* path, long seekTick, const char* csvPath) {
+	ReplayPlayer player;
+	if (!player.load(path) || !player.start(controller))
+		return 1;
+	FILE* csv = NULL;
+	if (csvPath && (csv = fopen(csvPath, "w")) == NULL) {
+		LOGE("cannot write %s", csvPath);
+		return 1;
+	}
+	if (seekTick >= 0) {
+		double start = now();
+		if (!player.seek(controller, seekTick)) {
+			LOGE("cannot seek to tick %ld, recorded from %ld to %ld", seekTick, player.getStartTick(),
+					player.getStartTick() + player.getTicks());
+			return 1;
+		}
+		printf("seek to tick %ld in %.3f ms\n", seekTick, (now() - start) * 1000);
+	} else {
+		double start = now();
+		long ticks = csv ? playFrames(controller, &player, csv) : player.play(controller, player.getTicks());
+		double elapsed = now() - start;
+		printf("replayed %ld ticks (%.1f s of play) in %.3f s, %.0f ticks/s\n", ticks,
+				ticks * TICK_TIME / 1000.0, elapsed, ticks / elapsed);
+	}
+	if (csv) {
+		fclose(csv);
+		printf("wrote %s\n", csvPath);
+	}
+	report(controller);
+	if (player.getDivergences()) {
+		printf("%ld divergences, first at tick %ld\n", player.getDivergences(), player.getFirstDivergence());
+		return 3;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	const char* assetsDir = PACMAN_ASSETS_DIR;
+	const char* recordPath = NULL;
+	const char* playPath = NULL;
+	long ticks = 30000;
+	long seed = time(NULL);
+	long seekTick = -1;
+	const char* resumePath = NULL;
+	const char* pausePath = NULL;
+	int rewindTicks = 0;
+	int turnWindow = -1;
+	const char* csvPath = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			ticks = atol(argv[++i]);
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			seed = atol(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+			playPath = argv[++i];
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			seekTick = atol(argv[++i]);
+		else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+			resumePath = argv[++i];
+		else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+			pausePath = argv[++i];
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			rewindTicks = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+			turnWindow = atoi(argv[++i]) / TICK_TIME;
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (argv[i][0] == '-') {
+			fprintf(stderr, "usage: %s [-t ticks] [-r seed] [-o out.rpl] [-l in.snp] [-w out.snp] [-b rewind-ticks] [-i turn-window-ms] [assets-dir]\n"
+					"       %s -p in.rpl [-s seek-tick | -c out.csv] [assets-dir]\n", argv[0], argv[0]);
+			return 2;
+		} else
+			assetsDir = argv[i];
+	}
+
+	AAssetManager* assetManager = AAssetManager_fromDirectory(assetsDir);
+	ReadLevel* readLevel = new ReadLevel(assetManager);
+	if (!readLevel->loadLevels()) {
+		LOGE("cannot load levels from %s", assetsDir);
+		return 1;
+	}
+	World* world = new World(readLevel->level);
+	WorldController* worldController = new WorldController(world);
+	LevelLoader* levelLoader = new LevelLoader(readLevel);
+	worldController->loader = levelLoader;
+
+	int result = 0;
+	if (playPath) {
+		result = replay(worldController, playPath, seekTick, csvPath);
+	} else {
+		srand48(seed);
+		if (turnWindow >= 0)
+			worldController->setTurnWindow(turnWindow);
+		if (resumePath && !worldController->onResume(resumePath)) {
+			LOGE("cannot resume from %s", resumePath);
+			return 1;
+		}
+		ReplayRecorder recorder(seed);
+		if (recordPath)
+			worldController->recorder = &recorder;
+		TouchQueue touches;
+		worldController->touches = &touches;
+		RewindBuffer rewind(rewindTicks);
+		if (rewindTicks > 0)
+			worldController->rewind = &rewind;
+		static const int directions[] = { LEFT, RIGHT, UP, DOWN };
+		long eaten[PLAYER_TURNED + 1] = { 0 };
+		long swipes = 0;
+		long latency[LATENCY_BUCKETS] = { 0 };
+		MazeMesh maze;
+		maze.build(world);
+		long frames = 0, uploaded = 0, maxUpload = 0;
+		double slowestSwap = 0;
+		for (long i = 0; i < ticks; i++) {
+			if (i % SWIPE_TICKS == 0) {
+				swipe(&touches, directions[lrand48() % 4]);
+				swipes++;
+			}
+			double start = now();
+			worldController->tick();
+			const EventBuffer& events = world->getEvents();
+			if (events.contains(LEVEL_CLEARED) && now() - start > slowestSwap)
+				slowestSwap = now() - start;
+			for (int e = 0; e < events.size(); e++) {
+				const GameEvent& event = events.get(e);
+				eaten[event.type]++;
+				if (event.type == PLAYER_TURNED)
+					latency[event.value < LATENCY_BUCKETS ? event.value : LATENCY_BUCKETS - 1]++;
+			}
+			if ((i + 1) % FRAME_TICKS == 0) {
+				long bytes = (long) maze.update(world) * MazeMesh::QUAD_BYTES;
+				uploaded += bytes;
+				if (bytes > maxUpload)
+					maxUpload = bytes;
+				frames++;
+			}
+		}
+		printf("seed %ld, %ld ticks (%.1f s of play)\n", seed, ticks, ticks * TICK_TIME / 1000.0);
+		report(worldController);
+		printf("events: %ld points, %ld bonuses, %ld spirits eaten, %ld deaths, %ld levels cleared\n",
+				eaten[PELLET_EATEN], eaten[BONUS_EATEN], eaten[SPIRIT_EATEN], eaten[PLAYER_DIED],
+				eaten[LEVEL_CLEARED]);
+		if (eaten[LEVEL_CLEARED])
+			printf("slowest level change tick %.1f us\n", slowestSwap * 1e6);
+		long turns = eaten[PLAYER_TURNED];
+		printf("%ld swipes, %ld turns", swipes, turns);
+		if (turns)
+			printf(", swipe to turn p50 %d p95 %d max %d ticks", percentile(latency, turns, 0.5),
+					percentile(latency, turns, 0.95), percentile(latency, turns, 1.0));
+		printf("\n");
+		printf("maze buffer %d bytes, %ld frames uploaded %ld bytes (%.1f per frame, max %ld)\n",
+				maze.getQuadCount() * MazeMesh::QUAD_BYTES, frames, uploaded,
+				frames ? (double) uploaded / frames : 0.0, maxUpload);
+		if (recordPath) {
+			if (!recorder.save(recordPath))
+				result = 1;
+			else
+				printf("recorded %s, %d bytes\n", recordPath, recorder.size());
+			if (!recorder.isRecording())
+				printf("recording stopped early: the level does not fit in a snapshot\n");
+		}
+		worldController->recorder = NULL;
+		worldController->rewind = NULL;
+		worldController->touches = NULL;
+		if (rewindTicks > 0) {
+			if (rewind.rewind(worldController, rewindTicks)) {
+				printf("rewound %d ticks\n", rewindTicks);
+				report(worldController);
+			} else {
+				LOGE("only %d ticks to rewind", rewind.size());
+				result = 1;
+			}
+		}
+		if (pausePath && !worldController->onPause(pausePath)) {
+			LOGE("cannot save game to %s", pausePath);
+			result = 1;
+		}
+	}
+
+	// World plays on the level's grids, so the level goes last.
+	delete worldController;
+	delete world;
+	delete levelLoader;
+	delete readLevel;
+	AAssetManager_delete(assetManager);
+	return result;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/LevelCompiler.h"
+
+// Offline level compiler. Turns a text map (see host/LevelCompiler.h) into
+// the binary level the game loads, or generates a benchmark maze:
+//
+//   pacman_levelc [-w width] [-h height] in.txt out.lvl
+//   pacman_levelc -g WIDTHxHEIGHT out.lvl
+//
+// The shipped maze is 25x15:
+//
+//   pacman_levelc assets/levels/111.txt assets/levels/111.lvl
+
+static char* readText(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return NULL;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char* text = new char[size + 1];
+	if (fread(text, 1, size, file) != (size_t) size) {
+		delete[] text;
+		text = NULL;
+	} else
+		text[size] = '\0';
+	fclose(file);
+	return text;
+}
+
+int main(int argc, char** argv) {
+	int width = 25;
+	int height = 15;
+	bool generate = false;
+	const char* paths[2];
+	int pathCount = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+			width = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-h") == 0 && i + 1 < argc)
+			height = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+			generate = sscanf(argv[++i], "%dx%d", &width, &height) == 2;
+			if (!generate)
+				pathCount = 3;
+		} else if (argv[i][0] != '-' && pathCount < 2)
+			paths[pathCount++] = argv[i];
+		else
+			pathCount = 3;
+	}
+	if (pathCount != (generate ? 1 : 2)) {
+		fprintf(stderr, "usage: %s [-w width] [-h height] in.txt out.lvl\n"
+				"       %s -g WIDTHxHEIGHT out.lvl\n", argv[0], argv[0]);
+		return 2;
+	}
+	const char* source = generate ? "generated maze" : paths[0];
+	const char* out = paths[generate ? 0 : 1];
+
+	char* text = generate ? generateLevel(width, height) : readText(paths[0]);
+	if (text == NULL) {
+		if (generate)
+			fprintf(stderr, "cannot generate a %dx%d maze\n", width, height);
+		else
+			fprintf(stderr, "cannot read %s\n", paths[0]);
+		return 1;
+	}
+	uint32_t size;
+	uint8_t* blob = compileLevel(text, width, height, &size);
+	int result = 0;
+	if (blob == NULL) {
+		fprintf(stderr, "%s: not a %dx%d level\n", source, width, height);
+		result = 1;
+	} else {
+		FILE* file = fopen(out, "wb");
+		if (file == NULL || fwrite(blob, size, 1, file) != 1 || fclose(file) != 0) {
+			fprintf(stderr, "cannot write %s\n", out);
+			result = 1;
+		} else
+			printf("%s: %dx%d, %u bytes\n", out, width, height, size);
+	}
+	delete[] blob;
+	delete[] text;
+	return result;
+}
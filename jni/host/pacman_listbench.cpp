@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <new>
+
+#include "templates/list.h"
+#include "host/OldList.h"
+
+// Microbenchmark of templates/list.h against the list it replaced, at the
+// sizes a level load produces: a list per brick of the 25x15 maze and a
+// list per cell of the 128x128 and 1024x1024 benchmark mazes. Reports
+// nanoseconds per item and heap allocations per list for appending
+// pointers one at a time, for appending after reserve(), and for reading
+// them back, plus building the four-item lists that fit a small buffer.
+//
+//   pacman_listbench [-i items-per-case]
+//
+// The old list grows by five slots at a time, so its appends are
+// quadratic; it is left out above OLD_LIST_LIMIT items.
+
+static const int SIZES[] = { 375, 16384, 1048576 };
+static const int SIZE_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+static const int OLD_LIST_LIMIT = 16384;
+
+static long allocations = 0;
+
+void* operator new(size_t size) {
+	allocations++;
+	void* p = malloc(size ? size : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) throw() {
+	free(p);
+}
+
+void operator delete[](void* p) throw() {
+	free(p);
+}
+
+void operator delete(void* p, size_t) throw() {
+	free(p);
+}
+
+void operator delete[](void* p, size_t) throw() {
+	free(p);
+}
+
+static uint64_t now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Keeps the compiler from dropping what is read back.
+static volatile uintptr_t sink;
+
+struct Result {
+	double append;
+	double reserved;
+	double iterate;
+	double allocations; // per list, appending one at a time
+};
+
+static void* item(int i) {
+	return (void*) (uintptr_t) (i * 8 + 8);
+}
+
+template <class L>
+static void fill(L& list, int size) {
+	for (int i = 0; i < size; i++)
+		list.append(item(i));
+}
+
+static Result measureOld(int size, int reps) {
+	Result result;
+	long before = allocations;
+	uint64_t start = now();
+	for (int r = 0; r < reps; r++) {
+		OldList<void*> list;
+		fill(list, size);
+		sink += (uintptr_t) list.get(size - 1);
+	}
+	result.append = (double) (now() - start) / reps / size;
+	result.allocations = (double) (allocations - before) / reps;
+	result.reserved = 0;
+
+	OldList<void*> list;
+	fill(list, size);
+	start = now();
+	for (int r = 0; r < reps; r++) {
+		uintptr_t sum = 0;
+		for (int i = 0; i < list.size(); i++)
+			sum += (uintptr_t) list.get(i);
+		sink += sum;
+	}
+	result.iterate = (double) (now() - start) / reps / size;
+	return result;
+}
+
+static Result measureNew(int size, int reps) {
+	Result result;
+	long before = allocations;
+	uint64_t start = now();
+	for (int r = 0; r < reps; r++) {
+		List<void*> list;
+		fill(list, size);
+		sink += (uintptr_t) list.get(size - 1);
+	}
+	result.append = (double) (now() - start) / reps / size;
+	result.allocations = (double) (allocations - before) / reps;
+
+	start = now();
+	for (int r = 0; r < reps; r++) {
+		List<void*> list;
+		list.reserve(size);
+		fill(list, size);
+		sink += (uintptr_t) list.get(size - 1);
+	}
+	result.reserved = (double) (now() - start) / reps / size;
+
+	List<void*> list;
+	fill(list, size);
+	start = now();
+	for (int r = 0; r < reps; r++) {
+		uintptr_t sum = 0;
+		for (void* p : list)
+			sum += (uintptr_t) p;
+		sink += sum;
+	}
+	result.iterate = (double) (now() - start) / reps / size;
+	return result;
+}
+
+// Four-item lists, one per spirit kind, built and dropped.
+template <class L>
+static void measureSmall(const char* name, long lists) {
+	long before = allocations;
+	uint64_t start = now();
+	for (long r = 0; r < lists; r++) {
+		L list;
+		fill(list, 4);
+		sink += (uintptr_t) list.get(3);
+	}
+	printf("%-16s %8d items %10.2f ns/list %26s %8.2f allocs/list\n", name, 4,
+			(double) (now() - start) / lists, "", (double) (allocations - before) / lists);
+}
+
+int main(int argc, char** argv) {
+	long items = 20000000;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+			items = atol(argv[++i]);
+		else {
+			fprintf(stderr, "usage: %s [-i items-per-case]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	for (int s = 0; s < SIZE_COUNT; s++) {
+		int size = SIZES[s];
+		int reps = items / size > 0 ? items / size : 1;
+		Result fresh = measureNew(size, reps);
+		printf("%-16s %8d items  append %6.2f  reserved %6.2f  iterate %6.2f ns/item %8.2f allocs/list\n",
+				"List", size, fresh.append, fresh.reserved, fresh.iterate, fresh.allocations);
+		if (size > OLD_LIST_LIMIT)
+			continue;
+		// Quadratic growth: fewer repetitions keep the old list's run short.
+		Result old = measureOld(size, reps / 16 > 0 ? reps / 16 : 1);
+		printf("%-16s %8d items  append %6.2f  %15s  iterate %6.2f ns/item %8.2f allocs/list\n",
+				"old List", size, old.append, "", old.iterate, old.allocations);
+	}
+	measureSmall<List<void*, 4> >("List<T, 4>", items / 4);
+	measureSmall<List<void*> >("List", items / 4);
+	measureSmall<OldList<void*> >("old List", items / 4);
+	return 0;
+}
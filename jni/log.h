@@ -1,10 +1,12 @@
 #ifndef LOG_H_
 #define LOG_H_
 
+#define  LOG_TAG    "pacman"
+
+#ifdef ANDROID_NDK
 #include <android/log.h>
 #include <GLES2/gl2.h>
 
-#define  LOG_TAG    "pacman"
 #define  LOGI(...)  __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define  LOGW(...)  __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
 #define  LOGE(...)  __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
@@ -14,5 +16,14 @@ static void checkGlError(const char* op) {
         LOGE("after %s glError (0x%x)\n", op, error);
     }
 }
+#else
+// Host builds: info and debug chatter is dropped, problems go to stderr.
+#include <stdio.h>
+
+#define  LOGI(...)  ((void) 0)
+#define  LOGW(...)  (fprintf(stderr, LOG_TAG ": " __VA_ARGS__), fputc('\n', stderr))
+#define  LOGE(...)  (fprintf(stderr, LOG_TAG ": " __VA_ARGS__), fputc('\n', stderr))
+#define  LOGD(...)  ((void) 0)
+#endif
 
 #endif
@@ -6,9 +6,13 @@
 #include <stdlib.h>
 
 
+#ifdef ANDROID_NDK
 #include <android/log.h>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
+#else
+#include "host/HostAssetManager.h"
+#endif
 
 class AAssetFile{
 private:
@@ -5,12 +5,14 @@
 #include "Point.h"
 #include "WorldObject.h"
 #include "View/ETexture.h"
+
+static const int BRICK_SIZE = 30;
+
+// Render view of a maze cell; gameplay reads the World tile grid instead.
 class Brick :public WorldObject{
 public:
 	Brick(){};
-	Brick(Point* position , int texture ,int width, int height);
-    bool tryToEat(Rectangle* rectangle);
-    bool tryToBonus(Rectangle* rectangle);
+	Brick(Point position , int texture ,int width, int height);
 };
 
 
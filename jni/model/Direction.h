@@ -6,4 +6,9 @@ LEFT=3,
 UP=1,
 DOWN=2,
 };
+
+// Whether value is one of the four headings; 0 means none.
+static inline bool isDirection(int value){
+	return value >= UP && value <= RIGHT;
+}
 #endif /* Direction_H_ */
@@ -0,0 +1,68 @@
+#ifndef Fixed_H_
+#define Fixed_H_
+
+#include <stdint.h>
+#include "model/Brick.h"
+#include "model/Direction.h"
+
+// Mover positions and speeds in 16.16 fixed point, counted in cells: a
+// mover at (x, y) has its top-left corner x / FIXED_ONE cells right of the
+// maze's. Movers keep to the lines between cell centres, so only the
+// coordinate along their heading is ever fractional, and they turn only
+// where both are whole.
+typedef int32_t fixed;
+
+static const int FIXED_SHIFT = 16;
+static const fixed FIXED_ONE = 1 << FIXED_SHIFT;
+static const fixed FIXED_FRACTION = FIXED_ONE - 1;
+
+static inline fixed cellToFixed(int cell) {
+	return cell * FIXED_ONE;
+}
+
+// Cell under the top-left corner; the shift floors, so movers partly left
+// of or above the grid map to -1.
+static inline int fixedToCell(fixed value) {
+	return value >> FIXED_SHIFT;
+}
+
+static inline int fixedToPixels(fixed value) {
+	return (int) (((int64_t) value * BRICK_SIZE) >> FIXED_SHIFT);
+}
+
+static inline bool atCellCentre(fixed x, fixed y) {
+	return ((x | y) & FIXED_FRACTION) == 0;
+}
+
+// Distance heading direction to the next cell centre: a whole cell when
+// already on one.
+static inline fixed toNextCentre(fixed x, fixed y, int direction) {
+	switch (direction) {
+	case RIGHT: return FIXED_ONE - (x & FIXED_FRACTION);
+	case LEFT:  return ((x - 1) & FIXED_FRACTION) + 1;
+	case DOWN:  return FIXED_ONE - (y & FIXED_FRACTION);
+	case UP:    return ((y - 1) & FIXED_FRACTION) + 1;
+	}
+	return 0;
+}
+
+static inline void advance(fixed* x, fixed* y, int direction, fixed distance) {
+	switch (direction) {
+	case RIGHT: *x += distance; break;
+	case LEFT:  *x -= distance; break;
+	case DOWN:  *y += distance; break;
+	case UP:    *y -= distance; break;
+	}
+}
+
+static inline int opposite(int direction) {
+	switch (direction) {
+	case RIGHT: return LEFT;
+	case LEFT:  return RIGHT;
+	case DOWN:  return UP;
+	case UP:    return DOWN;
+	}
+	return direction;
+}
+
+#endif /* Fixed_H_ */
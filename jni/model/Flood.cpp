@@ -0,0 +1,109 @@
+#include "Flood.h"
+#include <string.h>
+
+// Points the map at a maze's wall map, forgetting every label.
+void FloodMap::reset(const int* walls, int width, int height, bool standard) {
+	this->walls = walls;
+	this->width = width;
+	this->height = height;
+	this->standard = standard;
+	labels.resize(width * height);
+	stamps.resize(width * height);
+	queue.resize(width * height);
+	memset(stamps.data(), 0, width * height * sizeof(uint32_t));
+	generation = 1;
+	head = tail = 0;
+}
+
+void FloodMap::clear() {
+	if (++generation == 0) {
+		memset(stamps.data(), 0, stamps.size() * sizeof(uint32_t));
+		generation = 1;
+	}
+	head = tail = 0;
+}
+
+// Labels the unlabelled open neighbours of a labelled cell and queues them.
+template <class Grid>
+void FloodMap::expand(const Grid& grid, int index) const {
+	int step = labels[index] + 1;
+	int row = grid.x(index);
+	int column = grid.y(index);
+	int width = grid.width();
+	if (row > 0 && unlabelled(index - 1)) {
+		labels[index - 1] = step;
+		stamps[index - 1] = generation;
+		queue[tail++] = index - 1;
+	}
+	if (row < width - 1 && unlabelled(index + 1)) {
+		labels[index + 1] = step;
+		stamps[index + 1] = generation;
+		queue[tail++] = index + 1;
+	}
+	if (column > 0 && unlabelled(index - width)) {
+		labels[index - width] = step;
+		stamps[index - width] = generation;
+		queue[tail++] = index - width;
+	}
+	if (column < grid.height() - 1 && unlabelled(index + width)) {
+		labels[index + width] = step;
+		stamps[index + width] = generation;
+		queue[tail++] = index + width;
+	}
+}
+
+// Carries a lazy flood on until cell is labelled or every cell up to depth
+// is, and returns its label, or 0 if it has none.
+template <class Grid>
+int FloodMap::reach(const Grid& grid, int cell, int depth) const {
+	while (stamps[cell] != generation && head < tail && labels[queue[head]] < depth) {
+		expand(grid, queue[head++]);
+	}
+	return stamps[cell] == generation && labels[cell] <= depth ? labels[cell] : 0;
+}
+
+int FloodMap::reach(int cell, int depth) const {
+	if (standard)
+		return reach(StandardGrid(), cell, depth);
+	return reach(DynamicGrid(width, height), cell, depth);
+}
+
+template <class Grid>
+void FloodMap::flood(const Grid& grid, int target, int own, int minStep) {
+	int limit = FLOOD_WALL;
+	head = tail = 0;
+	if (at(target) == 1) {
+		queue[tail++] = target;
+		if (own == target) {
+			limit = minStep > 2 ? minStep : 2;
+		}
+	}
+
+	while (head < tail) {
+		int index = queue[head++];
+		if (labels[index] + 1 > limit) {
+			break;
+		}
+		expand(grid, index);
+		if (own >= 0 && limit == FLOOD_WALL) {
+			if (stamps[own] == generation && labels[own] != FLOOD_WALL) {
+				limit = labels[own] + 1 > minStep ? labels[own] + 1 : minStep;
+			}
+		}
+	}
+	head = tail = 0;
+}
+
+void FloodMap::flood(int target, int own, int minStep) {
+	if (standard)
+		flood(StandardGrid(), target, own, minStep);
+	else
+		flood(DynamicGrid(width, height), target, own, minStep);
+}
+
+void FloodMap::floodLazily(int target) {
+	clear();
+	set(target, 1);
+	queue[0] = target;
+	tail = 1;
+}
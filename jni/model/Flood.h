@@ -0,0 +1,73 @@
+#ifndef Flood_H_
+#define Flood_H_
+
+#include <stdint.h>
+#include "templates/AlignedArray.h"
+#include "model/Grid.h"
+
+// Larger than any distance, so no flood label can be mistaken for a wall.
+static const int FLOOD_WALL = 0x3fffffff;
+
+// Breadth-first distance labels over a maze, seeded with 1 at a target;
+// every reached cell gets its distance + 1. A cell not labelled since the
+// last clear() reads as the maze's wall map: 0 for open cells, FLOOD_WALL
+// for walls. clear() only moves on to a new generation, so a flood costs
+// the cells it reaches rather than the whole grid.
+class FloodMap {
+private:
+	mutable AlignedArray<int> labels;
+	mutable AlignedArray<uint32_t> stamps;
+	mutable AlignedArray<int> queue;
+	mutable int head;
+	mutable int tail;
+	uint32_t generation;
+	const int* walls;
+	int width;
+	int height;
+	bool standard;
+	bool unlabelled(int cell) const {
+		return stamps[cell] != generation && walls[cell] == 0;
+	}
+	template <class Grid> void expand(const Grid& grid, int index) const;
+	template <class Grid> int reach(const Grid& grid, int cell, int depth) const;
+	template <class Grid> void flood(const Grid& grid, int target, int own, int minStep);
+	int reach(int cell, int depth) const;
+	FloodMap(const FloodMap&);
+	FloodMap& operator=(const FloodMap&);
+public:
+	FloodMap() : head(0), tail(0), generation(0), walls(0), width(0), height(0), standard(false) {}
+	// standard floods through the StandardGrid kernels; the maze must be
+	// that size.
+	void reset(const int* walls, int width, int height, bool standard);
+	void clear();
+	void set(int cell, int label) {
+		labels[cell] = label;
+		stamps[cell] = generation;
+	}
+	// Floods from target, which the caller has labelled 1; unreached open
+	// cells stay 0. With own >= 0 the flood stops once own and its
+	// neighbours are labelled, and no sooner than every cell up to minStep
+	// is.
+	void flood(int target, int own, int minStep);
+	// Starts a flood from target that labels cells only as they are read,
+	// so readers pay for the cells up to the farthest one they look at.
+	void floodLazily(int target);
+	int at(int cell) const {
+		if (stamps[cell] == generation)
+			return labels[cell];
+		if (head < tail && walls[cell] == 0)
+			return reach(cell, FLOOD_WALL);
+		return walls[cell];
+	}
+	// As at(), but 0 for an open cell farther than depth - 1 steps from
+	// the target, without flooding any further to find out how far it is.
+	int within(int cell, int depth) const {
+		if (stamps[cell] == generation)
+			return labels[cell] <= depth || labels[cell] == FLOOD_WALL ? labels[cell] : 0;
+		if (head < tail && walls[cell] == 0)
+			return reach(cell, depth);
+		return walls[cell];
+	}
+};
+
+#endif /* Flood_H_ */
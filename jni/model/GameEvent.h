@@ -0,0 +1,49 @@
+#ifndef GameEvent_H_
+#define GameEvent_H_
+
+#include "templates/list.h"
+
+// Something that happened to the game during one tick. World appends them
+// as it moves the player and resolves contacts; sound, score and stats
+// only read them.
+enum GameEventType {
+	PELLET_EATEN,	// value: cell index
+	BONUS_EATEN,	// value: cell index
+	SPIRIT_EATEN,	// value: spirit id
+	PLAYER_DIED,	// value: lives left
+	LEVEL_CLEARED,	// value: 0
+	PLAYER_TURNED,	// value: ticks the swipe waited for the turn
+};
+
+struct GameEvent {
+	int type;
+	int value;
+};
+
+// Events of the current tick. A tick raises at most one of each kind, so
+// they fit in the buffer itself; should a future rule raise more (every
+// pellet under a fast mover, say) the rest spill to the heap and stay
+// there, since scores are counted from these and none may be lost.
+class EventBuffer {
+public:
+	static const int CAPACITY = 16;
+	void clear() { events.clear(); }
+	void append(int type, int value) {
+		GameEvent event;
+		event.type = type;
+		event.value = value;
+		events.append(event);
+	}
+	int size() const { return events.size(); }
+	const GameEvent& get(int index) const { return events.get(index); }
+	bool contains(int type) const {
+		for (int i = 0; i < events.size(); i++)
+			if (events.get(i).type == type)
+				return true;
+		return false;
+	}
+private:
+	List<GameEvent, CAPACITY> events;
+};
+
+#endif /* GameEvent_H_ */
@@ -0,0 +1,41 @@
+#ifndef Grid_H_
+#define Grid_H_
+
+// Maze geometry for the grid kernels, which are templates over one of
+// these. StaticGrid fixes the size at compile time, so strides, bounds and
+// loop counts fold into constants; DynamicGrid carries it at run time for
+// levels of any other size. Both have the same members.
+
+static const int STANDARD_WIDTH = 25;
+static const int STANDARD_HEIGHT = 15;
+
+template <int W, int H>
+struct StaticGrid {
+	int width() const { return W; }
+	int height() const { return H; }
+	int cells() const { return W * H; }
+	int words() const { return (W * H + 31) / 32; }
+	int x(int cell) const { return cell % W; }
+	int y(int cell) const { return cell / W; }
+};
+
+struct DynamicGrid {
+	int w;
+	int h;
+	DynamicGrid(int width, int height) : w(width), h(height) {}
+	int width() const { return w; }
+	int height() const { return h; }
+	int cells() const { return w * h; }
+	int words() const { return (w * h + 31) / 32; }
+	int x(int cell) const { return cell % w; }
+	int y(int cell) const { return cell / w; }
+};
+
+// The shipped mazes' size, which gets its own instantiation of each kernel.
+typedef StaticGrid<STANDARD_WIDTH, STANDARD_HEIGHT> StandardGrid;
+
+static inline bool isStandardGrid(int width, int height) {
+	return width == STANDARD_WIDTH && height == STANDARD_HEIGHT;
+}
+
+#endif /* Grid_H_ */
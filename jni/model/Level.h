@@ -1,22 +1,39 @@
 #ifndef Level_H_
 #define Level_H_
 
-#include "templates/list.h"
-#include "model/Brick.h"
+#include <stdint.h>
+#include "templates/Arena.h"
+#include "model/Point.h"
+#include "model/Tile.h"
+#include "model/NavTable.h"
+#include "model/Speed.h"
 
+// A loaded level. The grids point into blob, the compiled level as read
+// from the assets (see LevelBlob.h). Play never writes to it: World keeps
+// its own copy of the pellet bitsets. Everything the level allocates is in
+// its arena, released in one step when the next level is loaded into it.
 class Level{
 public:
-	  List<Brick*>* bricks;
-	  Point* pointBlinky;
-	  Point* pointInky;
-	  Point* pointPinky;
-	  Point* pointClyde;
-	  ~Level(){
-		  delete bricks;
-		  delete pointBlinky;
-		  delete pointInky;
-		  delete pointPinky;
-		  delete pointClyde;
-	  }
+	  Arena arena;
+	  uint8_t* blob;
+	  uint32_t blobSize;
+	  uint8_t* tiles; // row-major width*height grid of Tile kinds
+	  uint8_t* textures; // ETexture of each cell, same order as tiles
+	  const uint32_t* pellets; // bit per cell, set where the level starts with a point
+	  const uint32_t* power; // bit per cell, set where the level starts with a bonus
+	  const uint32_t* walkable; // bit per cell, set unless the cell is a wall
+	  int width;
+	  int height;
+	  int number; // position in the level pack, counting every level played
+	  bool standard; // played on the kernels specialised for StandardGrid
+	  int* wallMap; // flood map: 0 open, FLOOD_WALL for walls
+	  NavTable nav;
+	  LevelSpeeds speeds;
+	  Point pointBlinky;
+	  Point pointInky;
+	  Point pointPinky;
+	  Point pointClyde;
+	  Point pointPlayer;
+	  Level() : blob(NULL), blobSize(0), tiles(NULL), textures(NULL), pellets(NULL), power(NULL), walkable(NULL), width(0), height(0), number(0), standard(false), wallMap(NULL) {}
 };
 #endif /* Level_H_ */
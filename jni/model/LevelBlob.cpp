@@ -0,0 +1,103 @@
+#include "LevelBlob.h"
+
+#include <string.h>
+
+static const char LEVEL_MAGIC[4] = { 'P', 'L', 'V', 'L' };
+static const uint32_t LEVEL_VERSION = 3;
+
+static uint32_t align4(uint32_t offset) {
+	return (offset + 3) & ~3u;
+}
+
+// Fills in everything the header derives from the maze size: magic,
+// version, section offsets and total size. Start cells are left alone.
+void layoutLevel(LevelHeader* header, int width, int height) {
+	uint32_t cells = width * height;
+	uint32_t bitBytes = levelBitWords(width, height) * sizeof(uint32_t);
+	memcpy(header->magic, LEVEL_MAGIC, 4);
+	header->version = LEVEL_VERSION;
+	header->width = width;
+	header->height = height;
+	header->tiles = align4(sizeof(LevelHeader));
+	header->textures = align4(header->tiles + cells);
+	header->pellets = align4(header->textures + cells);
+	header->power = header->pellets + bitBytes;
+	header->walkable = header->power + bitBytes;
+	header->size = header->walkable + bitBytes;
+}
+
+static bool inside(const int32_t* cell, int width, int height) {
+	return cell[0] >= 0 && cell[0] < width && cell[1] >= 0 && cell[1] < height;
+}
+
+// What pacman_levelc guarantees and play relies on: known tile kinds, a
+// wall all round the border, so movers and the cells around them stay on
+// the grid, and bitsets that agree with the tiles.
+static bool checkCells(const uint8_t* blob, const LevelHeader* header) {
+	int width = header->width;
+	int height = header->height;
+	const uint8_t* tiles = blob + header->tiles;
+	const uint32_t* pellets = (const uint32_t*) (blob + header->pellets);
+	const uint32_t* power = (const uint32_t*) (blob + header->power);
+	const uint32_t* walkable = (const uint32_t*) (blob + header->walkable);
+	for (int i = 0; i < width * height; i++) {
+		int x = i % width;
+		int y = i / width;
+		int tile = tiles[i];
+		if (tile > TILE_DOOR)
+			return false;
+		if (tile != TILE_WALL && (x == 0 || y == 0 || x == width - 1 || y == height - 1))
+			return false;
+		if (levelBit(pellets, i) != (tile == TILE_POINT) || levelBit(power, i) != (tile == TILE_BONUS)
+				|| levelBit(walkable, i) != (tile != TILE_WALL))
+			return false;
+	}
+	return true;
+}
+
+static bool openCell(const uint8_t* blob, const LevelHeader* header, const int32_t* cell) {
+	return blob[header->tiles + cell[1] * header->width + cell[0]] != TILE_WALL;
+}
+
+// Points level into blob, which must stay alive and 4-byte aligned for as
+// long as the level is used. Fails without touching level if the blob is
+// not a complete, well-formed level of this version.
+bool mapLevel(Level* level, uint8_t* blob, uint32_t size) {
+	if (size < sizeof(LevelHeader) || ((uintptr_t) blob & 3))
+		return false;
+	const LevelHeader* header = (const LevelHeader*) blob;
+	int width = header->width;
+	int height = header->height;
+	if (memcmp(header->magic, LEVEL_MAGIC, 4) != 0 || header->version != LEVEL_VERSION
+			|| width <= 0 || width > LEVEL_MAX_SIDE || height <= 0 || height > LEVEL_MAX_SIDE)
+		return false;
+	LevelHeader expected;
+	layoutLevel(&expected, width, height);
+	if (header->size != size || expected.size != size
+			|| header->tiles != expected.tiles || header->textures != expected.textures
+			|| header->pellets != expected.pellets || header->power != expected.power
+			|| header->walkable != expected.walkable)
+		return false;
+	if (!inside(header->blinky, width, height) || !inside(header->pinky, width, height)
+			|| !inside(header->inky, width, height) || !inside(header->clyde, width, height)
+			|| !inside(header->player, width, height))
+		return false;
+	if (!checkCells(blob, header) || !openCell(blob, header, header->blinky) || !openCell(blob, header, header->pinky)
+			|| !openCell(blob, header, header->inky) || !openCell(blob, header, header->clyde)
+			|| !openCell(blob, header, header->player))
+		return false;
+
+	level->width = width;
+	level->height = height;
+	level->tiles = blob + header->tiles;
+	level->textures = blob + header->textures;
+	level->pellets = (const uint32_t*) (blob + header->pellets);
+	level->power = (const uint32_t*) (blob + header->power);
+	level->walkable = (const uint32_t*) (blob + header->walkable);
+	level->pointBlinky = Point(header->blinky[0], header->blinky[1]);
+	level->pointPinky = Point(header->pinky[0], header->pinky[1]);
+	level->pointInky = Point(header->inky[0], header->inky[1]);
+	level->pointClyde = Point(header->clyde[0], header->clyde[1]);
+	level->pointPlayer = Point(header->player[0], header->player[1]);
+	return true;
+}
@@ -0,0 +1,42 @@
+#ifndef LevelBlob_H_
+#define LevelBlob_H_
+
+#include <stdint.h>
+#include "model/Level.h"
+
+// Compiled level, as written by pacman_levelc from the text maps: a
+// LevelHeader followed by its sections at fixed, 4-byte aligned offsets.
+// Loading it is a bounds check and pointer setup; nothing is parsed.
+
+static const int LEVEL_MAX_SIDE = 1024;
+
+struct LevelHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t size;		// whole blob, header included
+	int32_t width;
+	int32_t height;
+	int32_t blinky[2];	// spawn cells, x then y
+	int32_t pinky[2];
+	int32_t inky[2];
+	int32_t clyde[2];
+	int32_t player[2];	// where the player starts
+	uint32_t tiles;		// offset of width*height Tile kinds
+	uint32_t textures;	// offset of width*height ETexture ids
+	uint32_t pellets;	// offset of a bit per cell, set on TILE_POINT
+	uint32_t power;		// offset of a bit per cell, set on TILE_BONUS
+	uint32_t walkable;	// offset of a bit per cell, set unless TILE_WALL
+};
+
+static inline int levelBitWords(int width, int height) {
+	return (width * height + 31) / 32;
+}
+
+static inline bool levelBit(const uint32_t* bits, int index) {
+	return (bits[index >> 5] >> (index & 31)) & 1;
+}
+
+void layoutLevel(LevelHeader* header, int width, int height);
+bool mapLevel(Level* level, uint8_t* blob, uint32_t size);
+
+#endif /* LevelBlob_H_ */
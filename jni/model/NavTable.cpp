@@ -0,0 +1,208 @@
+#include "NavTable.h"
+#include "Tile.h"
+#include "Direction.h"
+#include <string.h>
+
+static const char NAV_MAGIC[4] = { 'P', 'N', 'A', 'V' };
+static const int32_t NAV_VERSION = 1;
+
+struct NavHeader {
+	char magic[4];
+	int32_t version;
+	int32_t width;
+	int32_t height;
+	int32_t count;
+	uint32_t wallHash;
+};
+
+NavTable::NavTable() {
+	width = 0;
+	height = 0;
+	standard = false;
+	clear();
+}
+
+// Forgets the table, whose arrays went with their arena.
+void NavTable::clear() {
+	count = 0;
+	slots = NULL;
+	distances = NULL;
+	wallHash = 0;
+}
+
+// Numbers the open cells and hashes the wall layout (FNV-1a), so a cached
+// table can be matched against the level it was built for.
+void NavTable::index(Arena* arena, const uint8_t* tiles, int width, int height, bool standard) {
+	this->width = width;
+	this->height = height;
+	this->standard = standard;
+	slots = arena->allocate<int>(width * height);
+	count = 0;
+	wallHash = 2166136261u;
+	for (int i = 0; i < width * height; i++) {
+		bool wall = tiles[i] == TILE_WALL;
+		slots[i] = wall ? -1 : count++;
+		wallHash = (wallHash ^ (wall ? 1u : 0u)) * 16777619u;
+	}
+	wallHash = (wallHash ^ (uint32_t) width) * 16777619u;
+	wallHash = (wallHash ^ (uint32_t) height) * 16777619u;
+}
+
+bool NavTable::build(Arena* arena, const uint8_t* tiles, int width, int height, bool standard) {
+	distances = NULL;
+	index(arena, tiles, width, height, standard);
+	if (count > MAX_CELLS)
+		return false;
+
+	distances = arena->allocate<uint16_t>(count * count);
+	memset(distances, 0xff, count * count * sizeof(uint16_t));
+	int* cells = arena->allocate<int>(count);
+	int* queue = arena->allocate<int>(count);
+	for (int i = 0; i < width * height; i++) {
+		if (slots[i] >= 0)
+			cells[slots[i]] = i;
+	}
+
+	for (int source = 0; source < count; source++) {
+		uint16_t* row = distances + source * count;
+		int head = 0;
+		int tail = 0;
+		row[source] = 0;
+		queue[tail++] = cells[source];
+		while (head < tail) {
+			int cell = queue[head++];
+			uint16_t step = row[slots[cell]] + 1;
+			int x = cell % width;
+			int y = cell / width;
+			int neighbours[4] = {
+				x > 0 ? cell - 1 : -1,
+				x < width - 1 ? cell + 1 : -1,
+				y > 0 ? cell - width : -1,
+				y < height - 1 ? cell + width : -1,
+			};
+			for (int k = 0; k < 4; k++) {
+				int next = neighbours[k];
+				if (next >= 0 && slots[next] >= 0 && row[slots[next]] == UNREACHABLE) {
+					row[slots[next]] = step;
+					queue[tail++] = next;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Steps from grid cell from to the open cell in slot.
+int NavTable::slotDistance(int from, int slot) {
+	int fromSlot = slots[from];
+	if (fromSlot < 0)
+		return UNREACHABLE;
+	return distances[fromSlot * count + slot];
+}
+
+// Steps between two grid cells; from must be open. A wall target counts as
+// one step past its nearest open neighbour, as when a flood is seeded there.
+template <class Grid>
+int NavTable::distance(const Grid& grid, int from, int to) {
+	if (slots[to] >= 0)
+		return slotDistance(from, slots[to]);
+	int x = grid.x(to);
+	int y = grid.y(to);
+	int width = grid.width();
+	int neighbours[4] = {
+		x > 0 ? to - 1 : -1,
+		x < width - 1 ? to + 1 : -1,
+		y > 0 ? to - width : -1,
+		y < grid.height() - 1 ? to + width : -1,
+	};
+	int result = UNREACHABLE;
+	for (int k = 0; k < 4; k++) {
+		if (neighbours[k] >= 0 && slots[neighbours[k]] >= 0) {
+			int d = slotDistance(from, slots[neighbours[k]]);
+			if (d != UNREACHABLE && d + 1 < result)
+				result = d + 1;
+		}
+	}
+	return result;
+}
+
+int NavTable::distance(int from, int to) {
+	if (standard)
+		return distance(StandardGrid(), from, to);
+	return distance(DynamicGrid(width, height), from, to);
+}
+
+// Direction of the last neighbour of from, in LEFT, RIGHT, UP, DOWN order,
+// that is one step closer to to, skipping blocked; 0 if there is none.
+template <class Grid>
+int NavTable::nextDirection(const Grid& grid, int from, int to, int blocked) {
+	int step = distance(grid, from, to);
+	if (step == 0 || step == UNREACHABLE)
+		return 0;
+	int x = grid.x(from);
+	int y = grid.y(from);
+	int width = grid.width();
+	int result = 0;
+	if (x > 0 && from - 1 != blocked && distance(grid, from - 1, to) == step - 1)
+		result = LEFT;
+	if (x < width - 1 && from + 1 != blocked && distance(grid, from + 1, to) == step - 1)
+		result = RIGHT;
+	if (y > 0 && from - width != blocked && distance(grid, from - width, to) == step - 1)
+		result = UP;
+	if (y < grid.height() - 1 && from + width != blocked && distance(grid, from + width, to) == step - 1)
+		result = DOWN;
+	return result;
+}
+
+int NavTable::nextDirection(int from, int to, int blocked) {
+	if (standard)
+		return nextDirection(StandardGrid(), from, to, blocked);
+	return nextDirection(DynamicGrid(width, height), from, to, blocked);
+}
+
+bool NavTable::save(const char* path) {
+	if (!isReady())
+		return false;
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+	NavHeader header;
+	memcpy(header.magic, NAV_MAGIC, sizeof(header.magic));
+	header.version = NAV_VERSION;
+	header.width = width;
+	header.height = height;
+	header.count = count;
+	header.wallHash = wallHash;
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(distances, sizeof(uint16_t), count * count, file) == (size_t) (count * count);
+	fclose(file);
+	return ok;
+}
+
+// Loads a table saved for the same wall layout; fails on any mismatch,
+// handing back to the arena what it took so build() can start afresh.
+bool NavTable::load(Arena* arena, const char* path, const uint8_t* tiles, int width, int height, bool standard) {
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+	Arena::Mark mark = arena->mark();
+	distances = NULL;
+	index(arena, tiles, width, height, standard);
+	NavHeader header;
+	bool ok = fread(&header, sizeof(header), 1, file) == 1
+			&& memcmp(header.magic, NAV_MAGIC, sizeof(header.magic)) == 0
+			&& header.version == NAV_VERSION
+			&& header.width == width && header.height == height
+			&& header.count == count && header.wallHash == wallHash
+			&& count <= MAX_CELLS;
+	if (ok) {
+		distances = arena->allocate<uint16_t>(count * count);
+		ok = fread(distances, sizeof(uint16_t), count * count, file) == (size_t) (count * count);
+	}
+	fclose(file);
+	if (!ok) {
+		arena->release(mark);
+		clear();
+	}
+	return ok;
+}
@@ -0,0 +1,45 @@
+#ifndef NavTable_H_
+#define NavTable_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "model/Grid.h"
+#include "templates/Arena.h"
+
+// All-pairs shortest path lengths between the open cells of a static maze,
+// built once per level. Cells are row-major grid indices; only open cells
+// get a slot, so the shipped 25x15 maze (186 open cells) takes 69 KB. The
+// arrays live in the arena passed to build() or load(), normally the
+// level's, and go when it is reset.
+class NavTable {
+private:
+	int width;
+	int height;
+	int count;          // open cells
+	int* slots;         // grid index -> open cell slot, or -1 for walls
+	uint16_t* distances; // count*count steps, UNREACHABLE when disconnected
+	uint32_t wallHash;
+	bool standard;      // queries run on the StandardGrid kernels
+	void index(Arena* arena, const uint8_t* tiles, int width, int height, bool standard);
+	int slotDistance(int from, int slot);
+	template <class Grid> int distance(const Grid& grid, int from, int to);
+	template <class Grid> int nextDirection(const Grid& grid, int from, int to, int blocked);
+	NavTable(const NavTable&);
+	NavTable& operator=(const NavTable&);
+public:
+	static const uint16_t UNREACHABLE = 0xffff;
+	// Beyond this many open cells the table is not built and callers flood.
+	static const int MAX_CELLS = 1024;
+
+	NavTable();
+	void clear();
+	// standard asks for the StandardGrid kernels; the maze must be that size.
+	bool build(Arena* arena, const uint8_t* tiles, int width, int height, bool standard);
+	bool isReady() { return distances != NULL; }
+	int distance(int from, int to);
+	int nextDirection(int from, int to, int blocked);
+	bool save(const char* path);
+	bool load(Arena* arena, const char* path, const uint8_t* tiles, int width, int height, bool standard);
+};
+
+#endif /* NavTable_H_ */
@@ -1,37 +1,15 @@
 #include "Player.h"
 
-Player::Player(Point* position , int texture ,int width, int height) :WorldObjectMove(position,texture,width,height){
+Player::Player(Point position , int texture ,int width, int height) :WorldObjectMove(position,texture,width,height){
 		life = 3;
+		isOpen = false;
 		state = DEFENCE;
 	}
 
-bool Player::eatPoint(List<Brick*>* bricks){
-	for(int i=0; i < bricks->size(); i++){
-	            if(bricks->get(i)->tryToEat(bounds))
-	                return true;
-	        }
-	        return false;
-}
-
-bool Player::eatBonus(List<Brick*>* bricks) {
-	for(int i=0; i < bricks->size(); i++){
-		if(bricks->get(i)->tryToBonus(bounds)){
-           state = ATTACK;
-           return true;
-           }
-   }
-   return false;
-}
-
+// The mouth is open over half of every cell crossed, so it chews at the
+// player's pace whatever the frame rate.
 void Player::animate() {
-        bool change =
-                (getPosition()->getX() % 15 == 0 && (direction == LEFT || direction == RIGHT))
-                || (getPosition()->getY() % 15 == 0 && (direction == UP || direction == DOWN));
-
-        if(change){
-        	if(isOpen)isOpen = false;
-        	else isOpen = true;
-        }
+        isOpen = ((x | y) & (FIXED_ONE / 2)) != 0;
 
         if (direction == LEFT) {
             if (isOpen) {
@@ -71,3 +49,14 @@ void Player::animate() {
         this->life = life;
     }
 
+void Player::save(MoverSnapshot* snapshot) {
+	WorldObjectMove::save(snapshot);
+	snapshot->life = life;
+	snapshot->flag = isOpen;
+}
+
+void Player::restore(const MoverSnapshot& snapshot) {
+	WorldObjectMove::restore(snapshot);
+	life = snapshot.life;
+	isOpen = snapshot.flag != 0;
+}
@@ -10,16 +10,15 @@ private:
 	int life;
 	bool isOpen;
 public:
-Player(Point* position , int texture ,int width, int height);
+Player(Point position , int texture ,int width, int height);
 ~Player(){
 	LOGI("Player::~Player finished");
 };
-    bool eatPoint(List<Brick*>* bricks);
-    bool eatBonus(List<Brick*>* bricks);
-
     void animate();
     int getLife();
     void setLife(int life);
+    void save(MoverSnapshot* snapshot);
+    void restore(const MoverSnapshot& snapshot);
 
 };
 #endif /* Player_H_ */
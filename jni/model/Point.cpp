@@ -10,19 +10,11 @@ Point::Point(int x, int y, int width, int height) {
 	this->y = y * height;
 }
 
-Point::Point(Rectangle* rectangle) {
-	this->x = rectangle->getX();
-	this->y = rectangle->getY();
+Point::Point(const Rectangle& rectangle) {
+	this->x = rectangle.getX();
+	this->y = rectangle.getY();
 }
 
-int Point::getX() {
-	return x;
-}
-
-int Point::getY() {
-	return y;
-}
-
-Point* Point::multiply(int size) {
-	return new Point(x, y, size,size);
+Point Point::multiply(int size) const {
+	return Point(x, y, size,size);
 }
@@ -2,17 +2,19 @@
 #define Point_H_
 #include "model/Rectangle.h"
 
+// Small value type: copied, never allocated on the heap.
 class Point {
 private:
      int x;
      int y;
 
 public:
+    Point(): x(0), y(0) {}
     Point(int x, int y);
     Point(int x, int y,  int width, int height);
-    Point(Rectangle* rectangle);
-    int getX();
-    int getY();
-    Point* multiply(int size);
+    Point(const Rectangle& rectangle);
+    int getX() const { return x; }
+    int getY() const { return y; }
+    Point multiply(int size) const;
 };
 #endif /* Point_H_ */
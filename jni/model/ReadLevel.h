@@ -1,124 +1,133 @@
-#include "model/Brick.h"
+#ifndef ReadLevel_H_
+#define ReadLevel_H_
+
+#include "log.h"
+#include "model/AAssetFile.h"
 #include "model/Level.h"
+#include "model/LevelBlob.h"
+#include "model/Tile.h"
+#include "model/Flood.h"
+
+// Mazes in the order they are played; after the last the pack starts over.
+// Each name is a levels/<name>.lvl asset built by pacman_levelc.
+static const char* const LEVEL_PACK[] = { "111" };
+static const int LEVEL_PACK_SIZE = sizeof(LEVEL_PACK) / sizeof(LEVEL_PACK[0]);
+
 class ReadLevel{
 public:
-	char* token;
 	Level* level;
 	AAssetManager* assetManager;
+	const char* cacheDir; // where built navigation tables are kept, or NULL
+	bool navigation; // false leaves spirits on their flood-fill fallback
+	bool specialise; // false plays standard-size mazes on the dynamic-size kernels
 
+#ifdef ANDROID_NDK
 	ReadLevel(JNIEnv* env,  jobject javaAssetManager){
 		assetManager = AAssetManager_fromJava(env, javaAssetManager);
 		level = new Level();
+		cacheDir = NULL;
+		navigation = true;
+		specialise = true;
+	}
+#endif
+	ReadLevel(AAssetManager* assetManager){
+		this->assetManager = assetManager;
+		level = new Level();
+		cacheDir = NULL;
+		navigation = true;
+		specialise = true;
+	}
+	~ReadLevel(){
+		delete level;
 	}
-		int get_number() {
-			int res = 0;
+		// Loads the first level of the pack into level.
+		bool loadLevels(){
+				return loadLevel(0, level);
+		}
 
-			while (*token == ' ')
-				token++;
+		// Reads compiled level number (counted from 0, wrapping around the
+		// pack) into into's blob and points into at it; see LevelBlob.h and
+		// host/pacman_levelc.cpp. Touches only into, so the next level can be
+		// loaded on another thread while this one is played.
+		bool loadLevel(int number, Level* into){
+				const char* pack = LEVEL_PACK[number % LEVEL_PACK_SIZE];
+				char name[64];
+				snprintf(name, sizeof(name), "levels/%s.lvl", pack);
+				AAssetFile f = AAssetFile(assetManager, name);
+				if (f.getFile() == NULL) {
+					LOGE("level %s not found", name);
+					forget(into);
+					return false;
+				}
+				int size = f.size();
+				bool read = f.read(newBlob(into, size), size, 1) == size;
+				f.close();
+				if (!read || !prepareLevel(number, pack, into)) {
+					LOGE("level %s is not a compiled level", name);
+					forget(into);
+					return false;
+				}
+				return true;
+		}
 
-			while (*token >= '0' && *token <= '9') {
-				res = res * 10 + (*token - '0');
-				token++;
-			}
+		// Releases everything into held and gives it an empty blob of size
+		// bytes to read a compiled level into.
+		uint8_t* newBlob(Level* into, uint32_t size){
+				into->nav.clear();
+				into->wallMap = NULL;
+				into->arena.reset();
+				into->blob = into->arena.allocate<uint8_t>(size);
+				into->blobSize = size;
+				return into->blob;
+		}
 
-			return res;
+		// Empties into after a failed load, so no half-read grid is left in
+		// it to pass for a level.
+		void forget(Level* into){
+				into->nav.clear();
+				into->arena.reset();
+				into->blob = NULL;
+				into->blobSize = 0;
+				into->tiles = NULL;
+				into->textures = NULL;
+				into->pellets = NULL;
+				into->power = NULL;
+				into->walkable = NULL;
+				into->wallMap = NULL;
+				into->width = 0;
+				into->height = 0;
+				into->number = -1;
 		}
 
-		void loadLevels(){
-				char *  name = new char[64];
-				strcpy(name, "levels/111.txt");
-				AAssetFile f = AAssetFile(assetManager, name);
-				char buf[f.size()+1];
-				int count = f.read(&buf,f.size(),1);
-				buf[f.size()] = '\0';
-				f.close();
-				List<Brick*>* bricks = new List<Brick*>();
-				token = buf;
-				int x = 0;
-				int y = 0;
-				while (*token) {
-					switch (get_number()) {
-					            case 1:
-					            	bricks->append(new Brick(new Point(x, y), point,30,30));
-					                break;
-					            case 2:
-					            	bricks->append(new Brick(new Point(x, y), horizontal,30,30));
-					                break;
-					            case 3:
-					            	bricks->append(new Brick(new Point(x, y), vertical,30,30));
-					                break;
-					            case 4:
-					            	bricks->append(new Brick(new Point(x, y), angle_lv,30,30));
-					                break;
-					            case 5:
-					            	bricks->append(new Brick(new Point(x, y), angle_rv,30,30));
-					                break;
-					            case 6:
-					            	bricks->append(new Brick(new Point(x, y), angle_rd,30,30));
-					                break;
-					            case 7:
-					            	bricks->append(new Brick(new Point(x, y), angle_ld,30,30));
-					                break;
-					            case 8:
-					            	bricks->append(new Brick(new Point(x, y), arc_down,30,30));
-					                break;
-					            case 9:
-					            	bricks->append(new Brick(new Point(x, y), arc_left,30,30));
-					                break;
-					            case 10:
-					            	bricks->append(new Brick(new Point(x, y), arc_right,30,30));
-					                break;
-					            case 11:
-					            	bricks->append(new Brick(new Point(x, y), arc_up,30,30));
-					                break;
-					            case 12:
-					            	bricks->append(new Brick(new Point(x, y), arc2_down,30,30));
-					                break;
-					            case 13:
-					            	bricks->append(new Brick(new Point(x, y), arc2_right,30,30));
-					                break;
-					            case 14:
-					            	bricks->append(new Brick(new Point(x, y), arc2_left,30,30));
-					                break;
-					            case 15:
-					            	bricks->append(new Brick(new Point(x, y), arc2_up,30,30));
-					                break;
-					            case 16:
-					            	bricks->append(new Brick(new Point(x, y), bonus,30,30));
-					                break;
-					            case 90:
-					            	level->pointBlinky = new Point(x, y);
-					            	bricks->append(new Brick(new Point(x, y), none,30,30));
-					                break;
-					            case 91:
-					            	level->pointPinky = new Point(x, y);
-					            	bricks->append(new Brick(new Point(x, y), none,30,30));
-					                break;
-					            case 92:
-					            	level->pointClyde = new Point(x, y);
-					            	bricks->append(new Brick(new Point(x, y), none,30,30));
-					                break;
-					            case 93:
-					            	level->pointInky = new Point(x, y);
-					            	bricks->append(new Brick(new Point(x, y), none,30,30));
-					                break;
-					            case 99:
-					            	bricks->append(new Brick(new Point(x, y), none,30,30));
-					                break;
-					            default:
-					            	bricks->append(new Brick(new Point(x, y), background,30,30));
-					                break;
-					            }
-									x++;
-					            if (x == 25) {
-					                x = 0;
-					                y++;
-					            }
-					            if (y == 15) {
-					                y = 0;
-					            }
-					}
-				level->bricks = bricks;
+		// Points into at the compiled level already in its blob and builds
+		// what play needs besides; name keys the cached navigation table.
+		bool prepareLevel(int number, const char* name, Level* into){
+				if (!mapLevel(into, into->blob, into->blobSize))
+					return false;
+				into->number = number;
+				into->speeds = levelSpeeds(number);
+				into->standard = specialise && isStandardGrid(into->width, into->height);
+				int cells = into->width * into->height;
+				into->wallMap = into->arena.allocate<int>(cells);
+				for (int i = 0; i < cells; i++)
+					into->wallMap[i] = levelBit(into->walkable, i) ? 0 : FLOOD_WALL;
+				if (navigation)
+					loadNavTable(name, into);
+				return true;
+		}
+
+		// Warm starts read the table cached next to the level; cold starts
+		// build it and cache it for the next run.
+		void loadNavTable(const char* name, Level* into){
+				char path[256];
+				if (cacheDir)
+					snprintf(path, sizeof(path), "%s/%s.nav", cacheDir, name);
+				if (cacheDir && into->nav.load(&into->arena, path, into->tiles, into->width, into->height, into->standard))
+					return;
+				into->nav.build(&into->arena, into->tiles, into->width, into->height, into->standard);
+				if (cacheDir)
+					into->nav.save(path);
 		}
 
 };
+#endif /* ReadLevel_H_ */
@@ -1,5 +1,6 @@
 #ifndef Rectangle_H_
 #define Rectangle_H_
+// Small value type: copied, never allocated on the heap.
 class Rectangle {
 private:
     int x;
@@ -8,12 +9,13 @@ private:
     int height;
 
 public:
+    Rectangle(): x(0), y(0), width(0), height(0) {}
     Rectangle(int x, int y, int width, int height);
-    bool intersects(Rectangle* r);
-    int getY();
-    int getX();
-    int getWidht();
-    int getHeight();
+    bool intersects(const Rectangle& r) const;
+    int getY() const { return y; }
+    int getX() const { return x; }
+    int getWidht() const { return width; }
+    int getHeight() const { return height; }
 
 };
 #endif /* Rectangle_H_ */
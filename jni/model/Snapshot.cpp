@@ -0,0 +1,42 @@
+#include "Snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// Snapshot files are the struct behind a small header; a reader built with
+// a different layout rejects them rather than misreading them.
+struct SnapshotHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t size;
+};
+
+static const char SNAPSHOT_MAGIC[4] = { 'P', 'S', 'N', 'P' };
+static const uint32_t SNAPSHOT_VERSION = 3;
+
+bool writeSnapshot(const char* path, const Snapshot& snapshot) {
+	FILE* file = fopen(path, "wb");
+	if (file == NULL)
+		return false;
+	SnapshotHeader header;
+	memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+	header.version = SNAPSHOT_VERSION;
+	header.size = sizeof(Snapshot);
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+			&& fwrite(&snapshot, sizeof(Snapshot), 1, file) == 1;
+	return fclose(file) == 0 && written;
+}
+
+bool readSnapshot(const char* path, Snapshot* snapshot) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+	SnapshotHeader header;
+	bool read = fread(&header, sizeof(header), 1, file) == 1
+			&& memcmp(header.magic, SNAPSHOT_MAGIC, 4) == 0
+			&& header.version == SNAPSHOT_VERSION
+			&& header.size == sizeof(Snapshot)
+			&& fread(snapshot, sizeof(Snapshot), 1, file) == 1;
+	fclose(file);
+	return read;
+}
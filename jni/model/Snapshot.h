@@ -0,0 +1,60 @@
+#ifndef Snapshot_H_
+#define Snapshot_H_
+
+#include <stdint.h>
+
+// Plain-data image of everything the simulation carries from one tick to
+// the next. Fixed size and zero-filled before use, so two equal states are
+// byte-for-byte equal and can be hashed or compared with memcmp.
+
+static const int SNAPSHOT_SPIRITS = 8;
+static const int SNAPSHOT_CELLS = 512;
+
+struct MoverSnapshot {
+	int32_t x, y;		// top-left corner, 16.16 cells (see Fixed.h)
+	int32_t texture;
+	int32_t direction;
+	int32_t state;
+	int32_t life;		// player only
+	int32_t flag;		// spirits: white while frightened; player: mouth open
+};
+
+struct Snapshot {
+	// WorldController
+	int32_t tick;
+	int32_t turn;		// swipe waiting for its turn, or 0
+	int32_t turnTick;	// first tick it could be taken on
+	int32_t turnWindow;
+	int32_t second;
+	int32_t leftTime;
+	int32_t leftDefenceSpirit;
+	// World
+	int32_t level;
+	int32_t score;
+	int32_t countPoint;
+	int32_t leftSpirit;
+	int32_t spiritCount;
+	MoverSnapshot player;
+	MoverSnapshot spirits[SNAPSHOT_SPIRITS];
+	uint8_t points[SNAPSHOT_CELLS / 8];		// one bit per cell, row-major
+	uint8_t bonuses[SNAPSHOT_CELLS / 8];
+};
+
+// Fails to compile if the snapshot outgrows its budget.
+typedef char SnapshotFitsInOneKilobyte[sizeof(Snapshot) <= 1024 ? 1 : -1];
+
+bool writeSnapshot(const char* path, const Snapshot& snapshot);
+bool readSnapshot(const char* path, Snapshot* snapshot);
+
+// FNV-1a over the snapshot bytes.
+static inline uint32_t hashSnapshot(const Snapshot& snapshot) {
+	const uint8_t* bytes = (const uint8_t*) &snapshot;
+	uint32_t hash = 2166136261u;
+	for (unsigned i = 0; i < sizeof(Snapshot); i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+#endif /* Snapshot_H_ */
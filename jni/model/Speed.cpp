@@ -0,0 +1,40 @@
+#include "Speed.h"
+
+// The player's old pace: 5 pixels every 50 ms through 30-pixel cells.
+static const fixed BASE_SPEED = (fixed) ((int64_t) FIXED_ONE * 10 / 3);
+
+struct SpeedRow {
+	int fromLevel;
+	// Percentages of BASE_SPEED, in LevelSpeeds order.
+	int player, playerPowered, spirit, frightened, dead;
+};
+
+// After the arcade's table: everyone speeds up over the first levels, the
+// spirits faster than the player, and the player eases off again late on.
+// The first row keeps the first level at the speeds it always had, except
+// that frightened spirits now slow down and eaten ones hurry home.
+static const SpeedRow SPEED_TABLE[] = {
+	{ 0,  100, 110,  83, 55, 150 },
+	{ 1,  110, 115,  95, 60, 150 },
+	{ 4,  120, 120, 105, 65, 160 },
+	{ 20, 110, 110, 105, 65, 160 },
+};
+static const int SPEED_ROWS = sizeof(SPEED_TABLE) / sizeof(SPEED_TABLE[0]);
+
+static fixed percentOfBase(int percent) {
+	return (fixed) ((int64_t) BASE_SPEED * percent / 100);
+}
+
+LevelSpeeds levelSpeeds(int number) {
+	int row = 0;
+	while (row + 1 < SPEED_ROWS && SPEED_TABLE[row + 1].fromLevel <= number)
+		row++;
+	const SpeedRow& speeds = SPEED_TABLE[row];
+	LevelSpeeds result;
+	result.player = percentOfBase(speeds.player);
+	result.playerPowered = percentOfBase(speeds.playerPowered);
+	result.spirit = percentOfBase(speeds.spirit);
+	result.frightened = percentOfBase(speeds.frightened);
+	result.dead = percentOfBase(speeds.dead);
+	return result;
+}
@@ -0,0 +1,40 @@
+#ifndef Speed_H_
+#define Speed_H_
+
+#include "model/Fixed.h"
+
+// Length of a simulation tick in ms. Speeds are kept per second and turned
+// into a distance per tick when a level starts, so a build with longer
+// ticks for slow devices moves further each tick at the same pace. The
+// play is not the same, though: pellets and spirits are only checked
+// where the movers stop at the end of a tick, so contacts land on other
+// ticks and replays recorded at one tick length do not play back at
+// another. Ticks are capped so that the fastest mover (5 1/3 cells a
+// second) covers well under a cell per tick and cannot pass over a pellet
+// or through a spirit between two checks.
+#ifndef PACMAN_TICK_TIME
+#define PACMAN_TICK_TIME 10
+#endif
+static const int MAX_TICK_TIME = 100;
+
+// Fails to compile if the ticks are too long for the checks to keep up.
+typedef char TickTimeFitsTheChecks[PACMAN_TICK_TIME > 0 && PACMAN_TICK_TIME <= MAX_TICK_TIME ? 1 : -1];
+
+// How fast everything moves on one level, in cells per second (16.16).
+struct LevelSpeeds {
+	fixed player;
+	fixed playerPowered;	// while the player can eat spirits
+	fixed spirit;
+	fixed frightened;		// spirits in DEFENCE
+	fixed dead;			// eyes going home
+};
+
+// Speeds for the level played number-th, counting from 0.
+LevelSpeeds levelSpeeds(int number);
+
+// Distance covered in one tick of tickTime ms at speed cells per second.
+static inline fixed tickStep(fixed speed, int tickTime) {
+	return (fixed) (((int64_t) speed * tickTime + 500) / 1000);
+}
+
+#endif /* Speed_H_ */
@@ -1,25 +1,22 @@
 #include "model/Spirit/Blinky.h"
+#include "model/World.h"
 
-Blinky::Blinky(Point* point) :
-		Spirit(point, blinkyUp, 30, 30) {
-	START_POINT = new Point(point->getX(), point->getY());
-	DEFENCE_POINT = new Point(21, 1);
+Blinky::Blinky() {
+	DEFENCE_POINT = Point(-4, 1);
 }
 
-void Blinky::ai(World* world) {
-	switch (getState()) {
+void Blinky::ai(World* world, int id) {
+	switch (world->spirits.state[id]) {
 	case ATTACK:
-		findDirection(world, world->getPlayer()->getPosition(), this);
+		findDirection(world, id, world->getPlayer()->getPosition());
 		break;
 	case DEFENCE:
-		findDirection(world, DEFENCE_POINT->multiply(getWidth()), this);
+		findDirection(world, id, defencePoint(world).multiply(SIZE));
 		break;
 	case DEAD:
-		findDirection(world, START_POINT->multiply(getWidth()), this);
+		findDirection(world, id, startPoint(world, id).multiply(SIZE));
 		break;
 	}
-
-	move(world);
 }
 
 int Blinky::left() {
@@ -37,4 +34,3 @@ int Blinky::down() {
 int Blinky::up() {
 	return blinkyUp;
 }
-
@@ -8,8 +8,8 @@ class Blinky: public Spirit {
 
 public:
 	Blinky();
-	Blinky(Point* point);
-	void ai(World* world);
+protected:
+	void ai(World* world, int id);
 	int left();
 	int right();
 	int down();
@@ -1,35 +1,31 @@
 #include "model/Spirit/Clyde.h"
+#include "model/World.h"
 
-     Clyde::Clyde(Point* point): Spirit(point, clydeUp,30,30) {
-        START_POINT = new Point(point->getX(), point->getY());
-		DEFENCE_POINT = new Point(2, 13);
+     Clyde::Clyde() {
+		DEFENCE_POINT = Point(2, -2);
     }
 
-     void Clyde::ai(World* world) {
-        switch (getState()) {
+     void Clyde::ai(World* world, int id) {
+        switch (world->spirits.state[id]) {
         case ATTACK:
-            AIattack(world);
+            AIattack(world, id);
             break;
         case DEFENCE:
-            findDirection(world, DEFENCE_POINT->multiply(getWidth()), this);
+            findDirection(world, id, defencePoint(world).multiply(SIZE));
             break;
         case DEAD:
-            findDirection(world, START_POINT->multiply(getWidth()), this);
+            findDirection(world, id, startPoint(world, id).multiply(SIZE));
             break;
         }
-        move(world);
     }
 
-     void Clyde::AIattack(World* world) {
-        potencialMap(world->getPlayer()->getPosition(), this, world->bricks);
-
-        int** map = getMap();
-        int step = map[getPointX()][getPointY()];
+     void Clyde::AIattack(World* world, int id) {
+        int step = playerDistance(world, id);
 
         if (step <= 9) {
-            findDirection(world, new Point(1 , 2, getWidth(),getHeight()), this);
+            findDirection(world, id, Point(1 , 2, SIZE, SIZE));
         } else {
-            findDirection(world, world->getPlayer()->getPosition(), this);
+            findDirection(world, id, world->getPlayer()->getPosition());
         }
     }
 
@@ -48,4 +44,3 @@
      int Clyde::up() {
         return clydeUp;
     }
-
@@ -7,9 +7,9 @@ class Clyde: public Spirit {
 
 public:
 	Clyde();
-	Clyde(Point* point);
-	void ai(World* world);
-	void AIattack(World* world);
+protected:
+	void ai(World* world, int id);
+	void AIattack(World* world, int id);
 	int left();
 	int right();
 	int down();
@@ -1,32 +1,31 @@
 #include "Inky.h"
+#include "model/World.h"
 
-Inky::Inky(Point* point) :
-		Spirit(point, inkyUp, 30, 30) {
-	START_POINT = new Point(point->getX(), point->getY());
-	DEFENCE_POINT = new Point(21, 13);
+Inky::Inky() {
+	DEFENCE_POINT = Point(-4, -2);
 }
-   void Inky::ai(World* world) {
-        switch (getState()) {
+   void Inky::ai(World* world, int id) {
+        switch (world->spirits.state[id]) {
         case ATTACK:
-            findDirection(world, doubleVectorBetweenTwoPoints(findPathTwoStep(world), world->spirits->get(0)->getPosition() ), this);
+            // Inky works off the Blinky of its group of four.
+            findDirection(world, id, doubleVectorBetweenTwoPoints(world, findPathTwoStep(world, id), position(world->spirits, id - id % SPIRIT_KINDS)));
             break;
         case DEFENCE:
-            findDirection(world, DEFENCE_POINT->multiply(getWidth()), this);
+            findDirection(world, id, defencePoint(world).multiply(SIZE));
             break;
         case DEAD:
-            findDirection(world, START_POINT->multiply(getWidth()), this);
+            findDirection(world, id, startPoint(world, id).multiply(SIZE));
             break;
         }
-        move(world);
     }
 
-     Point* Inky::doubleVectorBetweenTwoPoints(Point* point1, Point* point2) {
+     Point Inky::doubleVectorBetweenTwoPoints(World* world, Point point1, Point point2) {
 
-        int aMatrix[] = { point2->getX() / getWidth(), point2->getY() / getHeight(), 1 };
+        int aMatrix[] = { point2.getX() / SIZE, point2.getY() / SIZE, 1 };
         int bMatrix[3][3] = { { -1, 0, 0 }, { 0, -1, 0 },
-                { 2 * (point1->getX() / getWidth()), 2 * (point1->getY() / getHeight()), 1 } };
+                { 2 * (point1.getX() / SIZE), 2 * (point1.getY() / SIZE), 1 } };
 
-        int point [3];
+        int point [3] = { 0, 0, 0 };
 
         for (int column = 0; column < 3; column++) {
             for (int inner = 0; inner < 3; inner++) {
@@ -35,68 +34,27 @@ Inky::Inky(Point* point) :
 
         }
 
-        if (point[X] >= 25) {
-            point[X] = 24;
+        // Clamped to the maze: x may reach the right border, y stops
+        // above the bottom one.
+        if (point[X] >= world->getWidth()) {
+            point[X] = world->getWidth() - 1;
         }
         if (point[X] < 1) {
             point[X] = 1;
         }
-        if (point[Y] >= 14) {
-            point[Y] = 13;
+        if (point[Y] >= world->getHeight() - 1) {
+            point[Y] = world->getHeight() - 2;
         }
         if (point[Y] < 1) {
             point[Y] = 1;
         }
 
-        return new Point(point[X], point[Y],getWidth(), getHeight());
+        return Point(point[X], point[Y],SIZE, SIZE);
     }
 
 
-     Point* Inky::findPathTwoStep(World* world) {
-        potencialMap(world->getPlayer()->getPosition(), this, world->bricks);
-
-        int** map = getMap();
-        int min = 0;
-        int max = 999;
-
-        Point* point = new Point(0,0);
-        for (int row = 0; row < world->getWidth(); row++) {
-            for (int column = 0; column < world->getHeight(); column++) {
-                if (map[row][column] == 3) {
-
-                    if (world->getPlayer()->getDirection() == LEFT) {
-                        if (max > row) {
-                            max = row;
-                            point = new Point(row, column,getWidth(), getHeight());
-                        }
-                    }
-
-                    if (world->getPlayer()->getDirection() == RIGHT) {
-                        if (min < row) {
-                            min = row;
-                            point = new Point(row, column,getWidth(), getHeight());
-                        }
-                    }
-
-                    if (world->getPlayer()->getDirection() == UP) {
-                        if (max > column) {
-                            max = column;
-                            point = new Point(row, column,getWidth(), getHeight());
-                        }
-                    }
-
-                    if (world->getPlayer()->getDirection() == DOWN) {
-                        if (min < column) {
-                            min = column;
-                            point = new Point(row, column,getWidth(), getHeight());
-                        }
-                    }
-
-                }
-            }
-        }
-
-        return point;
+     Point Inky::findPathTwoStep(World* world, int id) {
+        return aheadOnRing(world, id, 3);
     }
 
      int Inky::left() {
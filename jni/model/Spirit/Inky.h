@@ -9,13 +9,13 @@ class Inky: public Spirit {
 private:
 	 static const  int Y = 1;
 	 static const int X = 0;
-	 Point* doubleVectorBetweenTwoPoints(Point* point1, Point* point2);
-	 Point* findPathTwoStep(World* world);
+	 Point doubleVectorBetweenTwoPoints(World* world, Point point1, Point point2);
+	 Point findPathTwoStep(World* world, int id);
 
 public:
 	Inky();
-	Inky(Point* point);
-	void ai(World* world);
+protected:
+	void ai(World* world, int id);
 	int left();
 	int right();
 	int down();
@@ -0,0 +1,40 @@
+#ifndef Movers_H_
+#define Movers_H_
+
+#include <stdint.h>
+#include "templates/AlignedArray.h"
+#include "model/Fixed.h"
+
+// Spirit state as parallel arrays indexed by spirit id. Sweeps over every
+// spirit (state changes, contacts, drawing) read a few contiguous lines
+// instead of chasing one heap object per spirit.
+class Movers {
+private:
+	int count;
+	Movers(const Movers&);
+	Movers& operator=(const Movers&);
+public:
+	Movers() : count(0) {}
+	AlignedArray<fixed> x, y;			// top-left corner, see Fixed.h
+	AlignedArray<int> direction;
+	AlignedArray<int> state;
+	AlignedArray<int> texture;
+	AlignedArray<int> startX, startY;	// home cell
+	AlignedArray<uint8_t> kind;			// SpiritKind, picks the behaviour
+	AlignedArray<uint8_t> white;		// flashing white at the end of DEFENCE
+	int size() const { return count; }
+	void resize(int count) {
+		this->count = count;
+		x.resize(count);
+		y.resize(count);
+		direction.resize(count);
+		state.resize(count);
+		texture.resize(count);
+		startX.resize(count);
+		startY.resize(count);
+		kind.resize(count);
+		white.resize(count);
+	}
+};
+
+#endif /* Movers_H_ */
@@ -7,11 +7,11 @@
 class Pinky: public Spirit {
 
 private:
-	Point* findPathFourStep(World* world);
+	Point findPathFourStep(World* world, int id);
 public:
 	Pinky();
-	Pinky(Point* point);
-	void ai(World* world);
+protected:
+	void ai(World* world, int id);
 	int left();
 	int right();
 	int down();
@@ -1,222 +1,305 @@
 #include "model/Spirit/Spirit.h"
+#include "model/Spirit/Blinky.h"
+#include "model/Spirit/Clyde.h"
+#include "model/Spirit/Inky.h"
+#include "model/Spirit/Pinky.h"
 #include "model/World.h"
+#include <string.h>
 
-Spirit::Spirit(Point* position, int texture, int width, int height) :
-		WorldObjectMove(position, texture, width, height) {
-
-		setState(ATTACK);
-		setCountStep(0);
-	}
-
-     void Spirit::refresh(World* world) {
-        if (getState() == DEAD) {
-        	setState( world->collidesWithRefresh(getBounds()));
-        }
-    }
-
-     void Spirit::go(World* world) {
-        createMap(25, 15);
-        ai(world);
-    }
-
-     void Spirit::onLoadImageAttack() {
-        switch (direction) {
-        case LEFT:
-            setTexture(left());
-            break;
-        case RIGHT:
-            setTexture(right());
-            break;
-        case DOWN:
-            setTexture(down());
-            break;
-        case UP:
-            setTexture(up());
-            break;
-        }
-    }
-
-     void Spirit::onLoadImageDead() {
-        switch (direction) {
-        case LEFT:
-            setTexture(orbLeft);
-            break;
-        case RIGHT:
-            setTexture(orbRight);
-            break;
-        case UP:
-            setTexture(orbUp);
-            break;
-        case DOWN:
-            setTexture(orbDown);
-            break;
-        }
-    }
-
-     void Spirit::onLoadImageDefence(bool isWhite) {
-        if (isWhite) {
-            setTexture(spiritDefenceWhite);
-        } else {
-            setTexture(spiritDefence);
-        }
-    }
-
-     void Spirit::onLoadImage() {
-        switch (getState()) {
-        case ATTACK:
-            onLoadImageAttack();
-            break;
-        case DEFENCE:
-            onLoadImageDefence(leftDefence);
-            break;
-        case DEAD:
-            onLoadImageDead();
-            break;
-        }
-    }
-
-    void Spirit::move(World* world) {
-        onLoadImage();
-        refresh(world);
-        onMove(direction);
-
-        if (!world->collidesWithLevel(getBounds())) {
-            setPosition(getBounds());
-        }
-        countStep++;
-    }
-
-    void Spirit::findDirection(World* world, Point* point, Spirit* spirit) {
-        potencialMap(point, spirit, world->bricks);
-        if (getCountStep() >= (30 / SPEED)) {
-            int ** map = getMap();
-
-            int step = map[getPointX()][getPointY()];
-
-            if (map[getPointX() - 1][getPointY()] < step + 1) {
-                setDirection(LEFT);
-            }
-            if (map[getPointX() + 1][getPointY()] < step + 1) {
-                setDirection(RIGHT);
-            }
-            if (map[getPointX()][getPointY() - 1] < step + 1) {
-                setDirection(UP);
-            }
-            if (map[getPointX()][getPointY() + 1] < step + 1) {
-                setDirection(DOWN);
-            }
-
-            setCountStep(0);
-        }
-    }
-
-    int Spirit::getCountStep() {
-        return countStep;
-    }
-
-    void Spirit::setCountStep(int countStep) {
-        this->countStep = countStep;
-    }
-
-    void Spirit::setDefence(bool isDefence) {
-        this->leftDefence = isDefence;
-    }
-
-    void Spirit::createMap(int width, int height) {
-            this->width = width;
-            this->height = height;
-            map = new int*[width];
-                for (int i=0; i<width; i++)
-                    map[i] = new int[height];
-        }
-
-     void Spirit::potencialMap(Point* point, Spirit* spirit, List<Brick*>* bricks) {
-            inverseMap(bricks);
-            int count = 0;
-            step = 2;
-
-            map[point->getX() / 30][point->getY() / 30] = 1;
-
-            if (spirit->getState() != DEAD) {
-                changeMap(spirit);
-            }
-
-            while (count < 40) {
-                for (int row = 0; row < width; row++) {
-                    for (int column = 0; column < height; column++) {
-                        if (map[row][column] == step - 1) {
-                            if (row > 1) {
-                                if (map[row - 1][column] == 0) {
-                                    map[row - 1][column] = step;
-                                }
-                            }
-                            if (row < width - 1) {
-                                if (map[row + 1][column] == 0) {
-                                    map[row + 1][column] = step;
-                                }
-                            }
-                            if (column > 1) {
-                                if (map[row][column - 1] == 0) {
-                                    map[row][column - 1] = step;
-                                }
-                            }
-                            if (column < height - 1) {
-                                if (map[row][column + 1] == 0) {
-                                    map[row][column + 1] = step;
-                                }
-                            }
-                        }
-                    }
-                }
-                step++;
-                count++;
-            }
-
-        }
-
-         void Spirit::changeMap(Spirit* spirit) {
-            if (spirit->getDirection() == LEFT) {
-                map[(spirit->getPointX()) + 1][spirit->getPointY()] = WALL;
-            }
-
-            if (spirit->getDirection() == RIGHT) {
-                map[(spirit->getPointX()) - 1][spirit->getPointY()] = WALL;
-            }
-
-            if (spirit->getDirection() == UP) {
-                map[spirit->getPointX()][(spirit->getPointY()) + 1] = WALL;
-            }
-
-            if (spirit->getDirection() == DOWN) {
-                map[spirit->getPointX()][(spirit->getPointY()) - 1] = WALL;
-            }
-        }
-
-         void Spirit::inverseMap(List<Brick*>* bricks) {
-            int row = 0;
-            int column = 0;
-            for(int i=0; i < bricks->size(); i++){
-            		if(bricks->get(i)->getTexture() == background
-                        || bricks->get(i)->getTexture() == point
-                        || bricks->get(i)->getTexture() == none
-                        || bricks->get(i)->getTexture() == bonus) {
-                    map[row][column] = 0;
-                } else {
-                    map[row][column] = WALL;
-                }
-                row++;
-                if (row == width) {
-                    row = 0;
-                    column++;
-                }
-                if (column == height) {
-                    column = 0;
-                }
-            }
-        }
-
-         int** Spirit::getMap() {
-            return map;
-        }
+Spirit* Spirit::of(int kind) {
+	static Blinky blinky;
+	static Clyde clyde;
+	static Inky inky;
+	static Pinky pinky;
+	switch (kind) {
+	case CLYDE:
+		return &clyde;
+	case INKY:
+		return &inky;
+	case PINKY:
+		return &pinky;
+	}
+	return &blinky;
+}
+
+// A spirit of the given kind standing in its home cell, facing up.
+void Spirit::place(Movers& movers, int id, int kind, Point start) {
+	movers.kind[id] = kind;
+	movers.startX[id] = start.getX();
+	movers.startY[id] = start.getY();
+	movers.state[id] = ATTACK;
+	movers.texture[id] = of(kind)->up();
+	movers.white[id] = false;
+	home(movers, id);
+}
+
+// Back in the home cell facing up, as at the start: a spirit may not turn
+// back, so one still facing the way it was going could be left facing a
+// wall with its only way out behind it.
+void Spirit::home(Movers& movers, int id) {
+	movers.direction[id] = UP;
+	movers.x[id] = cellToFixed(movers.startX[id]);
+	movers.y[id] = cellToFixed(movers.startY[id]);
+}
+
+// Moves spirit id as far as its state's speed takes it in a tick. Each
+// cell centre on the way is a stop where it picks its heading again, so
+// every turn is taken exactly on a centre however far a tick goes; facing
+// a wall it waits there.
+void Spirit::go(World* world, int id) {
+	Movers& movers = world->spirits;
+	Spirit* spirit = of(movers.kind[id]);
+	refresh(world, id);
+	fixed& x = movers.x[id];
+	fixed& y = movers.y[id];
+	fixed left = world->getSpiritStep(movers.state[id]);
+	while (left > 0) {
+		if (atCellCentre(x, y)) {
+			spirit->ai(world, id);
+			if (!world->canEnter(x, y, movers.direction[id])) {
+				break;
+			}
+		}
+		fixed run = toNextCentre(x, y, movers.direction[id]);
+		if (run > left) {
+			run = left;
+		}
+		advance(&x, &y, movers.direction[id], run);
+		left -= run;
+	}
+	spirit->onLoadImage(world, id);
+}
+
+void Spirit::refresh(World* world, int id) {
+	Movers& movers = world->spirits;
+	if (movers.state[id] == DEAD) {
+		movers.state[id] = world->collidesWithRefresh(bounds(movers, id));
+	}
+}
+
+void Spirit::onLoadImage(World* world, int id) {
+	Movers& movers = world->spirits;
+	int texture = movers.texture[id];
+	switch (movers.state[id]) {
+	case ATTACK:
+		switch (movers.direction[id]) {
+		case LEFT:  texture = left();  break;
+		case RIGHT: texture = right(); break;
+		case DOWN:  texture = down();  break;
+		case UP:    texture = up();    break;
+		}
+		break;
+	case DEFENCE:
+		texture = movers.white[id] ? spiritDefenceWhite : spiritDefence;
+		break;
+	case DEAD:
+		switch (movers.direction[id]) {
+		case LEFT:  texture = orbLeft;  break;
+		case RIGHT: texture = orbRight; break;
+		case UP:    texture = orbUp;    break;
+		case DOWN:  texture = orbDown;  break;
+		}
+		break;
+	}
+	movers.texture[id] = texture;
+}
+
+void Spirit::findDirection(World* world, int id, Point point) {
+	Movers& movers = world->spirits;
+	int direction = closerNeighbour(world, id, point);
+	if (direction) {
+		movers.direction[id] = direction;
+		return;
+	}
+
+	const FloodMap* map = potencialMap(world, id, point);
+	int width = world->getWidth();
+	int own = cellY(world, id) * width + cellX(world, id);
+	int step = map->at(own);
+
+	if (map->at(own - 1) < step + 1) {
+		movers.direction[id] = LEFT;
+	}
+	if (map->at(own + 1) < step + 1) {
+		movers.direction[id] = RIGHT;
+	}
+	if (map->at(own - width) < step + 1) {
+		movers.direction[id] = UP;
+	}
+	if (map->at(own + width) < step + 1) {
+		movers.direction[id] = DOWN;
+	}
+}
+
+Point Spirit::startPoint(World* world, int id) {
+	return Point(world->spirits.startX[id], world->spirits.startY[id]);
+}
+
+Point Spirit::defencePoint(World* world) {
+	int x = DEFENCE_POINT.getX();
+	int y = DEFENCE_POINT.getY();
+	return Point(x < 0 ? world->getWidth() + x : x, y < 0 ? world->getHeight() + y : y);
+}
+
+int Spirit::cellX(World* world, int id) {
+	return fixedToCell(world->spirits.x[id]);
+}
+
+int Spirit::cellY(World* world, int id) {
+	return fixedToCell(world->spirits.y[id]);
+}
+
+// Direction one step closer to point without turning back, read from the
+// level's navigation table or, for the player, the map World shares
+// between spirits; 0 when only a private flood can decide. Walling off
+// the cell behind the spirit only lengthens paths through that cell, so
+// while another neighbour is one step closer this matches the flood.
+int Spirit::closerNeighbour(World* world, int id, Point point) {
+	int width = world->getWidth();
+	int own = cellY(world, id) * width + cellX(world, id);
+	int target = (point.getY() / SIZE) * width + point.getX() / SIZE;
+	NavTable* nav = world->getNavTable();
+	if (nav) {
+		return nav->nextDirection(own, target, behind(world, id));
+	}
+	Point player = world->getPlayer()->getPosition();
+	if (target == (player.getY() / SIZE) * width + player.getX() / SIZE) {
+		return closerNeighbour(world, id, world->getPlayerMap());
+	}
+	return 0;
+}
+
+// Distance label of the spirit's cell in its own flood from the player.
+int Spirit::playerDistance(World* world, int id) {
+	Point player = world->getPlayer()->getPosition();
+	int width = world->getWidth();
+	int own = cellY(world, id) * width + cellX(world, id);
+	NavTable* nav = world->getNavTable();
+	if (nav && closerNeighbour(world, id, player)) {
+		return nav->distance(own, (player.getY() / SIZE) * width + player.getX() / SIZE) + 1;
+	}
+	const FloodMap* field = world->getPlayerMap();
+	if (!nav && closerNeighbour(world, id, field)) {
+		return field->at(own);
+	}
+	return potencialMap(world, id, player)->at(own);
+}
+
+// Map whose cells labelled ring are those of the spirit's own flood from
+// the player. The wall behind the spirit only relabels cells farther from
+// the player than itself, so the shared map serves unless it is that close.
+const FloodMap* Spirit::playerRing(World* world, int id, int ring) {
+	const FloodMap* field = world->getPlayerMap();
+	int back = behind(world, id);
+	int label = back < 0 ? 0 : field->within(back, ring);
+	if (label == 0 || label > ring) {
+		return field;
+	}
+	return potencialMap(world, id, world->getPlayer()->getPosition(), ring);
+}
+
+// Cell labelled ring in playerRing() farthest along the player's heading,
+// the first found scanning columns left to right, each top to bottom; the
+// origin if there is none. A ring cell is ring - 1 steps from the player,
+// so only the square that far around the player's cell is scanned.
+Point Spirit::aheadOnRing(World* world, int id, int ring) {
+	const FloodMap* field = playerRing(world, id, ring);
+	Player* player = world->getPlayer();
+	int width = world->getWidth();
+	int height = world->getHeight();
+	int direction = player->getDirection();
+	int x0 = player->getPointX() - (ring - 1);
+	int x1 = player->getPointX() + (ring - 1);
+	int y0 = player->getPointY() - (ring - 1);
+	int y1 = player->getPointY() + (ring - 1);
+
+	Point point(0, 0);
+	int min = 0;
+	int max = 999;
+	for (int row = x0 < 0 ? 0 : x0; row <= x1 && row < width; row++) {
+		for (int column = y0 < 0 ? 0 : y0; column <= y1 && column < height; column++) {
+			if (field->within(column * width + row, ring) != ring) {
+				continue;
+			}
+			int along = direction == LEFT || direction == RIGHT ? row : column;
+			if ((direction == LEFT || direction == UP) && max > along) {
+				max = along;
+				point = Point(row, column, SIZE, SIZE);
+			}
+			if ((direction == RIGHT || direction == DOWN) && min < along) {
+				min = along;
+				point = Point(row, column, SIZE, SIZE);
+			}
+		}
+	}
+	return point;
+}
+
+// Direction of the last neighbour, in LEFT, RIGHT, UP, DOWN order, that is
+// one step closer in field, skipping the cell behind the spirit; 0 if none.
+int Spirit::closerNeighbour(World* world, int id, const FloodMap* field) {
+	int width = world->getWidth();
+	int own = cellY(world, id) * width + cellX(world, id);
+	int step = field->at(own);
+	int back = behind(world, id);
+	int result = 0;
+	if (step <= 1) {
+		return 0;
+	}
+	if (own - 1 != back && field->at(own - 1) == step - 1) {
+		result = LEFT;
+	}
+	if (own + 1 != back && field->at(own + 1) == step - 1) {
+		result = RIGHT;
+	}
+	if (own - width != back && field->at(own - width) == step - 1) {
+		result = UP;
+	}
+	if (own + width != back && field->at(own + width) == step - 1) {
+		result = DOWN;
+	}
+	return result;
+}
 
+// Index of the cell a spirit may not turn back into, or -1 when it is DEAD
+// and may turn around.
+int Spirit::behind(World* world, int id) {
+	Movers& movers = world->spirits;
+	if (movers.state[id] == DEAD) {
+		return -1;
+	}
+	int width = world->getWidth();
+	int own = cellY(world, id) * width + cellX(world, id);
+	switch (movers.direction[id]) {
+	case LEFT:
+		return own + 1;
+	case RIGHT:
+		return own - 1;
+	case UP:
+		return own + width;
+	case DOWN:
+		return own - width;
+	}
+	return -1;
+}
+
+// Floods the world's scratch map from point, with the cell behind the
+// spirit walled off, and returns it. Spirits move one after another, so a
+// single scratch map serves them all.
+const FloodMap* Spirit::potencialMap(World* world, int id, Point point, int minStep) {
+	int width = world->getWidth();
+	FloodMap* map = world->getSpiritMap();
+	map->clear();
+
+	int target = (point.getY() / SIZE) * width + point.getX() / SIZE;
+	map->set(target, 1);
+
+	int back = behind(world, id);
+	if (back >= 0) {
+		map->set(back, WALL);
+	}
 
+	int own = cellY(world, id) * width + cellX(world, id);
+	map->flood(target, own, minStep);
+	return map;
+}
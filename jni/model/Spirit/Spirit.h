@@ -2,59 +2,71 @@
 #define Spirit_H_
 
 #include "model/Point.h"
-#include "model/WorldObjectMove.h"
-#include "templates/list.h"
+#include "model/Rectangle.h"
+#include "model/Flood.h"
 #include "model/Brick.h"
-#include "model/World.h"
+#include "model/Direction.h"
+#include "model/State.h"
+#include "model/Spirit/Movers.h"
 #include "View/ETexture.h"
 
+enum SpiritKind {
+	BLINKY,
+	CLYDE,
+	INKY,
+	PINKY,
+	SPIRIT_KINDS
+};
 
 class World;
-class Spirit: public WorldObjectMove {
-protected:
-	Point* START_POINT;
-	Point* DEFENCE_POINT;
 
+// Behaviour of one kind of spirit. Nothing here belongs to a single spirit:
+// spirit id's state lives in World's Movers arrays, so the one instance per
+// kind returned by of() drives any number of spirits.
+class Spirit {
 public:
-	Spirit();
-	~Spirit(){
-		for (int i = 0; i < width; i++)
-		  delete map[i];
-		delete map;
-	};
-	Spirit(Point* position , int texture ,int width, int height);
-	virtual void ai(World* world){};
-	virtual int left(){};
-	virtual int right(){};
-	virtual int down(){};
-	virtual int up(){};
-	void go(World* world);
-	void move(World* world);
-	void findDirection(World* world, Point* point, Spirit* spirit);
-	int getCountStep();
-	void setCountStep(int countStep);
-	void setDefence(bool isDefence);
-	Point* getStartPoint(){return START_POINT;}
+	static const int SIZE = BRICK_SIZE;
+	static const int WALL = FLOOD_WALL;
+
+	virtual ~Spirit(){};
+	static Spirit* of(int kind);
+	static void go(World* world, int id);
+	static void place(Movers& movers, int id, int kind, Point start);
+	static void home(Movers& movers, int id);
+	static Rectangle bounds(const Movers& movers, int id) {
+		return Rectangle(fixedToPixels(movers.x[id]), fixedToPixels(movers.y[id]), SIZE, SIZE);
+	}
+	static Point position(const Movers& movers, int id) {
+		return Point(fixedToPixels(movers.x[id]), fixedToPixels(movers.y[id]));
+	}
 
-private:
-	int countStep;
-	bool leftDefence;
-	void refresh(World* world);
-	void onLoadImageAttack();
-	void onLoadImageDead();
-	void onLoadImageDefence(bool isWhite);
-	void onLoadImage();
 protected:
-    static const int WALL = 200;
-     int **map;
-     int step;
-     int width;
-     int height;
-     void changeMap(Spirit* spirit);
-     void inverseMap(List<Brick*>* bricks);
-     void createMap(int width, int height);
-     void potencialMap(Point* point, Spirit* spirit, List<Brick*>* bricks);
-     int ** getMap();
+	// Cell a frightened spirit heads for; negative coordinates count back
+	// from the right and bottom edges, so it sits in the same corner of any
+	// maze. Read it through defencePoint().
+	Point DEFENCE_POINT;
+
+	// Picks the spirit's heading; called with it on a cell centre.
+	virtual void ai(World* world, int id) = 0;
+	virtual int left() = 0;
+	virtual int right() = 0;
+	virtual int down() = 0;
+	virtual int up() = 0;
+	void findDirection(World* world, int id, Point point);
+	Point startPoint(World* world, int id);
+	Point defencePoint(World* world);
+	static int cellX(World* world, int id);
+	static int cellY(World* world, int id);
+	static int behind(World* world, int id);
+	static int closerNeighbour(World* world, int id, const FloodMap* field);
+	static int closerNeighbour(World* world, int id, Point point);
+	static int playerDistance(World* world, int id);
+	static const FloodMap* playerRing(World* world, int id, int ring);
+	static Point aheadOnRing(World* world, int id, int ring);
+	static const FloodMap* potencialMap(World* world, int id, Point point, int minStep = 0);
 
+private:
+	void onLoadImage(World* world, int id);
+	static void refresh(World* world, int id);
 };
 #endif /* Spirit_H_ */
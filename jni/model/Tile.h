@@ -0,0 +1,7 @@
+#ifndef Tile_H_
+#define Tile_H_
+// Gameplay kind of a maze cell, kept apart from the brick's render texture.
+enum Tile{
+	TILE_EMPTY, TILE_WALL, TILE_POINT, TILE_BONUS, TILE_DOOR,
+};
+#endif /* Tile_H_ */
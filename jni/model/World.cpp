@@ -1,124 +1,402 @@
 #include "World.h"
-#include "model/Spirit/Blinky.h"
-#include "model/Spirit/Clyde.h"
-#include "model/Spirit/Inky.h"
-#include "model/Spirit/Pinky.h"
-
-World::World(Level* level){
-	player = new Player(new Point(10,9),pacmanUpOpen,30,30);
-	player->setDirection(LEFT);
-	spirits = new List<Spirit*>();
-	spirits->append(new Blinky(level->pointBlinky));
-	spirits->append(new Clyde(level->pointClyde));
-	spirits->append(new Inky(level->pointInky));
-	spirits->append(new Pinky(level->pointPinky));
-	bricks = level->bricks;
-	generationPoint();
+#include <string.h>
+
+// The player and the spirits' arrays are made once here and reset in place
+// from then on, on every death, new game and level.
+World::World(Level* level, int spiritCount) : player(level->pointPlayer,pacmanUpOpen,30,30){
+	spirits.resize(spiritCount);
+	gridNext.resize(spiritCount);
+	gridCell.resize(spiritCount);
+	contacts.resize(spiritCount);
 	score = 0;
+	loadLevel(level);
+}
+
+// Starts level with the score and lives carried over. Buffers sized for the
+// previous level are kept when the new one has the same size, so moving on
+// to the next maze allocates nothing.
+void World::loadLevel(Level* level){
+	this->level = level;
+	tiles = level->tiles;
+	textures = level->textures;
+	width = level->width;
+	height = level->height;
+	standard = level->standard;
+	wallMap = level->wallMap;
+	playerMap.reset(wallMap, width, height, standard);
+	spiritMap.reset(wallMap, width, height, standard);
+	playerMapCell = -1;
+	navTable = level->nav.isReady() ? &level->nav : NULL;
+	const LevelSpeeds& speeds = level->speeds;
+	playerStep = tickStep(speeds.player, PACMAN_TICK_TIME);
+	poweredStep = tickStep(speeds.playerPowered, PACMAN_TICK_TIME);
+	spiritSteps[ATTACK] = tickStep(speeds.spirit, PACMAN_TICK_TIME);
+	spiritSteps[DEFENCE] = tickStep(speeds.frightened, PACMAN_TICK_TIME);
+	spiritSteps[DEAD] = tickStep(speeds.dead, PACMAN_TICK_TIME);
+	int words = levelBitWords(width, height);
+	pellets.resize(words);
+	power.resize(words);
+	dirtyTiles.resize(words);
+	memset(dirtyTiles.data(), 0, words * sizeof(uint32_t));
+	dirtyCells.resize(width * height);
+	dirtyCount = 0;
+	gridHead.resize(width * height);
+	for(int i=0; i < width * height; i++){
+		gridHead[i] = -1;
+	}
+	for(int i=0; i < spirits.size(); i++){
+		gridCell[i] = -1;
+	}
+	restartLevel();
+	clearDirtyTiles();
+}
+
+template <class Grid>
+void World::refill(const Grid& grid){
+	int words = grid.words();
+	for(int i=0; i < words; i++){
+		markDirtyWord(i, (pellets[i] ^ level->pellets[i]) | (power[i] ^ level->power[i]));
+	}
+	memcpy(pellets.data(), level->pellets, words * sizeof(uint32_t));
+	memcpy(power.data(), level->power, words * sizeof(uint32_t));
 	countPoint = 0;
-	leftSpirit=3;
+	for(int i=0; i < words; i++){
+		countPoint += __builtin_popcount(pellets[i]);
+	}
+}
+
+// Puts every pellet back and the movers on their starting cells. The
+// bitsets come back with one memcpy each; cells whose bits change are
+// flagged dirty for the renderer.
+void World::restartLevel(){
+	int life = player.getLife();
+	player = Player(level->pointPlayer,pacmanUpOpen,30,30);
+	player.setLife(life);
+	player.setDirection(LEFT);
+	// Spirits take the four behaviours in turn, each from its own spawn.
+	static const int kinds[SPIRIT_KINDS] = {BLINKY, CLYDE, INKY, PINKY};
+	const Point spawns[SPIRIT_KINDS] = {level->pointBlinky, level->pointClyde,
+			level->pointInky, level->pointPinky};
+	for(int i=0; i < spirits.size(); i++){
+		Spirit::place(spirits, i, kinds[i % SPIRIT_KINDS], spawns[i % SPIRIT_KINDS]);
+	}
+	if (standard)
+		refill(StandardGrid());
+	else
+		refill(DynamicGrid(width, height));
+	leftSpirit = spirits.size() - 1;
+}
+
+bool World::isVictory(){
+	return countPoint == 0;
 }
 
 World::~World(){
 	LOGI("World::~World");
-	delete player;
-	delete bricks;
-	delete spirits;
 	LOGI("World::~World finished");
 }
 
-void World::tryToPlayerGo(int direction){
-	player->onMove(direction);
-	if(!collidesWithLevel(player->getBounds())){
-		player->setDirection(direction);
+// Moves the player as far as its speed takes it in a tick, turning to
+// direction (0 for none) where it can: straight back at once, any other
+// way at the first cell centre that opens onto it. Blocked ahead it waits
+// on the centre. Returns whether the player now heads direction; a turn
+// taken raises PLAYER_TURNED with waited, the ticks it was held for.
+bool World::tryToPlayerGo(int direction, int waited){
+	fixed x = player.getX();
+	fixed y = player.getY();
+	fixed left = player.getState() == ATTACK ? poweredStep : playerStep;
+	bool turned = false;
+	if (direction && direction == opposite(player.getDirection())) {
+		player.setDirection(direction);
+		turned = true;
 	}
-	player->onMove(player->getDirection());
-	if(!collidesWithLevel(player->getBounds())){
-		player->setPosition(player->getBounds());
+	while (left > 0) {
+		if (atCellCentre(x, y)) {
+			if (!turned && direction && direction != player.getDirection() && canEnter(x, y, direction)) {
+				player.setDirection(direction);
+				turned = true;
+			}
+			if (!canEnter(x, y, player.getDirection()))
+				break;
+		}
+		fixed run = toNextCentre(x, y, player.getDirection());
+		if (run > left)
+			run = left;
+		advance(&x, &y, player.getDirection(), run);
+		left -= run;
 	}
-	eatBonus();
+	player.moveTo(x, y);
+	if (turned)
+		events.append(PLAYER_TURNED, waited);
+	return direction && player.getDirection() == direction;
+}
 
+// Whether a mover on the cell centre (x, y) can set off in direction.
+bool World::canEnter(fixed x, fixed y, int direction){
+	int cellX = fixedToCell(x);
+	int cellY = fixedToCell(y);
+	switch (direction) {
+	case RIGHT: cellX++; break;
+	case LEFT:  cellX--; break;
+	case DOWN:  cellY++; break;
+	case UP:    cellY--; break;
+	}
+	return getTile(cellX, cellY) != TILE_WALL;
 }
 
 Player* World::getPlayer(){
-	return player;
+	return &player;
 }
 
+// Distance map from the player's cell, shared read-only by every spirit.
+// Walls are static, so it is restarted only when the player changes cell,
+// and it floods only as far out as the spirits read it.
+const FloodMap* World::getPlayerMap(){
+	int cell = player.getPointY() * width + player.getPointX();
+	if (cell != playerMapCell) {
+		playerMap.floodLazily(cell);
+		playerMapCell = cell;
+	}
+	return &playerMap;
+}
+
+// Puts a point on every floor cell that has neither a point nor a bonus.
 int World::generationPoint(){
 	int result=0;
-	for(int i=0; i < bricks->size(); i++){
-		if(bricks->get(i)->getTexture() == background){
-			bricks->get(i)->setTexture(point);
+	for(int i=0; i < width * height; i++){
+		if(getTile(i % width, i / width) == TILE_EMPTY){
+			pellets[i >> 5] |= 1u << (i & 31);
+			markDirty(i);
 			result++;
 		}
 	}
+	countPoint += result;
 	return result;
 }
 
+// Every pellet change is flagged here so the renderer only has to look at
+// the cells that changed. The bitset keeps each cell on the list once.
+void World::markDirtyWord(int word, uint32_t bits){
+	bits &= ~dirtyTiles[word];
+	dirtyTiles[word] |= bits;
+	for(; bits; bits &= bits - 1){
+		dirtyCells[dirtyCount++] = word * 32 + __builtin_ctz(bits);
+	}
+}
+
+void World::markDirty(int index){
+	markDirtyWord(index >> 5, 1u << (index & 31));
+}
+
+void World::clearDirtyTiles(){
+	for(int i=0; i < dirtyCount; i++){
+		dirtyTiles[dirtyCells[i] >> 5] = 0;
+	}
+	dirtyCount = 0;
+}
+
+// Floor division, so movers partly left of or above the grid map to -1.
+static int tileOf(int pixel) {
+	return pixel >= 0 ? pixel / BRICK_SIZE : (pixel - BRICK_SIZE + 1) / BRICK_SIZE;
+}
+
+// Looks for a tile of the given kind among the 1-4 tiles under rect, in
+// brick order. Cells outside the grid count as walls.
+template <class Grid>
+bool World::findTile(const Grid& grid, Rectangle rect, int kind, int* index){
+	if (rect.getWidht() <= 0 || rect.getHeight() <= 0)
+		return false;
+	int x1 = tileOf(rect.getX() + rect.getWidht() - 1);
+	int y1 = tileOf(rect.getY() + rect.getHeight() - 1);
+	for (int y = tileOf(rect.getY()); y <= y1; y++) {
+		for (int x = tileOf(rect.getX()); x <= x1; x++) {
+			if (getTile(grid, x, y) == kind) {
+				if (index)
+					*index = y * grid.width() + x;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool World::findTile(Rectangle rect, int kind, int* index){
+	if (standard)
+		return findTile(StandardGrid(), rect, kind, index);
+	return findTile(DynamicGrid(width, height), rect, kind, index);
+}
+
+bool World::eatTile(Rectangle rect, int kind, int* index){
+	if (!findTile(rect, kind, index))
+		return false;
+	uint32_t* bits = kind == TILE_POINT ? pellets.data() : power.data();
+	bits[*index >> 5] &= ~(1u << (*index & 31));
+	markDirty(*index);
+	return true;
+}
+
+// The level is cleared when its last point is eaten.
 bool World::eatPoint(){
-	  if (player->eatPoint(bricks)) {
-		  	  	  countPoint--;
-		  	  	  score += 50;
-	            return true;
-	        }
-	        return false;
+	int index;
+	if (eatTile(player.getBounds(), TILE_POINT, &index)) {
+		events.append(PELLET_EATEN, index);
+		if (--countPoint == 0)
+			events.append(LEVEL_CLEARED, 0);
+		return true;
+	}
+	return false;
 }
 
 bool World::eatBonus(){
-        if (player->eatBonus(bricks)) {
-            score += 500;
+        int index;
+        if (eatTile(player.getBounds(), TILE_BONUS, &index)) {
+            events.append(BONUS_EATEN, index);
+            player.setState(ATTACK);
             defenceNPC();
             return true;
         }
         return false;
     }
 
+// Everything the player touched this tick, checked once after the player
+// has moved. Scores come from the tick's events, so each is counted once
+// whichever check raised it.
+void World::resolveContacts(){
+	eatPoint();
+	eatBonus();
+	indexSpirits();
+	spiritContacts();
+	for(int i=0; i < events.size(); i++){
+		switch (events.get(i).type) {
+		case PELLET_EATEN:
+			score += 50;
+			break;
+		case BONUS_EATEN:
+			score += 500;
+			break;
+		case SPIRIT_EATEN:
+			score += 1000;
+			break;
+		}
+	}
+}
+
 
 void World::defenceNPC(){
-	for(int i=0; i < spirits->size(); i++){
-	            if (spirits->get(i)->getState() == ATTACK) {
-	            	spirits->get(i)->setState(DEFENCE);
-	            }
-	        }
+	int* state = spirits.state.data();
+	for(int i=0; i < spirits.size(); i++){
+		if (state[i] == ATTACK)
+			state[i] = DEFENCE;
+	}
 }
 
 void World::attackNPC(){
-	for(int i=0; i < spirits->size(); i++){
-		if (spirits->get(i)->getState() == DEFENCE) {
-			spirits->get(i)->setState(ATTACK);
-          }
-      }
-      player->setState(DEFENCE);
-}
-
-bool World::deadSpirit(){
-	for(int i=0; i < spirits->size(); i++){
-            if ((spirits->get(i)->getBounds()->intersects(player->getBounds()))) {
-                if (player->getState() == ATTACK && spirits->get(i)->getState() != DEAD){
-                    score += 1000;
-                    spirits->get(i)->setState(DEAD);
-                    return true;
-                }
-            }
-        }
-        return false;
+	int* state = spirits.state.data();
+	for(int i=0; i < spirits.size(); i++){
+		if (state[i] == DEFENCE)
+			state[i] = ATTACK;
+	}
+	player.setState(DEFENCE);
+}
+
+// Clamped to the grid, so movers partly outside still have a bucket.
+static int clampTile(int pixel, int size) {
+	int tile = tileOf(pixel);
+	return tile < 0 ? 0 : tile >= size ? size - 1 : tile;
+}
+
+static int clampCell(fixed value, int size) {
+	int cell = fixedToCell(value);
+	return cell < 0 ? 0 : cell >= size ? size - 1 : cell;
+}
+
+// Buckets every spirit by the tile under its top-left corner. Each bucket lists its spirits in id order. Only the
+// buckets filled last time are emptied, so this costs nothing per cell.
+void World::indexSpirits(){
+	for(int i=0; i < spirits.size(); i++){
+		if (gridCell[i] >= 0)
+			gridHead[gridCell[i]] = -1;
+	}
+	for(int i=spirits.size() - 1; i >= 0; i--){
+		int cell = clampCell(spirits.y[i], height) * width + clampCell(spirits.x[i], width);
+		gridCell[i] = cell;
+		gridNext[i] = gridHead[cell];
+		gridHead[cell] = i;
+	}
+}
+
+// Writes to ids, in increasing order, the spirits whose rectangle overlaps
+// rect as of the last indexSpirits(), and returns how many there are; ids
+// must have room for every spirit. rect is at most a tile across, as
+// spirits are, so only the 3x3 buckets from one tile up and left of it to
+// its bottom-right corner can hold one.
+int World::touchingSpirits(Rectangle rect, int* ids){
+	int x = rect.getX();
+	int y = rect.getY();
+	int right = x + rect.getWidht();
+	int bottom = y + rect.getHeight();
+	if (right <= x || bottom <= y)
+		return 0;
+	int x0 = clampTile(x - Spirit::SIZE + 1, width);
+	int x1 = clampTile(right - 1, width);
+	int y0 = clampTile(y - Spirit::SIZE + 1, height);
+	int y1 = clampTile(bottom - 1, height);
+
+	// Merge the buckets' id-ordered lists.
+	int next[9];
+	int buckets = 0;
+	for(int ty=y0; ty <= y1 && ty <= y0 + 2; ty++){
+		for(int tx=x0; tx <= x1 && tx <= x0 + 2; tx++){
+			int head = gridHead[ty * width + tx];
+			if (head >= 0)
+				next[buckets++] = head;
+		}
+	}
+	const fixed* spiritX = spirits.x.data();
+	const fixed* spiritY = spirits.y.data();
+	int count = 0;
+	while (buckets > 0) {
+		int lowest = 0;
+		for(int b=1; b < buckets; b++){
+			if (next[b] < next[lowest])
+				lowest = b;
+		}
+		int i = next[lowest];
+		next[lowest] = gridNext[i];
+		if (next[lowest] < 0)
+			next[lowest] = next[--buckets];
+		int left = fixedToPixels(spiritX[i]);
+		int top = fixedToPixels(spiritY[i]);
+		if (left < right && x < left + Spirit::SIZE && top < bottom && y < top + Spirit::SIZE)
+			ids[count++] = i;
+	}
+	return count;
 }
 
-bool World::deadPlayer(){
-	for(int i=0; i < spirits->size(); i++){
-	            if ((spirits->get(i)->getBounds()->intersects(player->getBounds()))) {
-	                if (spirits->get(i)->getState() == ATTACK){
-	                    player->setState(DEAD);
-	                    player->setLife(player->getLife() - 1);
-	                    return true;
-	                }
-	            }
-	        }
-	        return false;
+// One pass over the spirits touching the player, in id order. While
+// frightened the player eats the first live one; otherwise the first
+// attacking spirit kills the player. At most one of each per tick.
+void World::spiritContacts(){
+	bool eaten = false;
+	int count = touchingSpirits(player.getBounds(), contacts.data());
+	for(int k=0; k < count; k++){
+		int i = contacts[k];
+		if (!eaten && player.getState() == ATTACK && spirits.state[i] != DEAD){
+			spirits.state[i] = DEAD;
+			events.append(SPIRIT_EATEN, i);
+			eaten = true;
+		}
+		if (spirits.state[i] == ATTACK){
+			player.setState(DEAD);
+			player.setLife(player.getLife() - 1);
+			events.append(PLAYER_DIED, player.getLife());
+			return;
+		}
+	}
 }
 
 bool World::eatFruit(){
-//        if(fruit->getBounds()->intersects(player->getBounds()) && fruit->getTexture()!= none){
+//        if(fruit->getBounds().intersects(player.getBounds()) && fruit->getTexture()!= none){
 //            fruit->setTexture(Texture->none);
 //            score += 500;
 //            return true;
@@ -126,37 +404,107 @@ bool World::eatFruit(){
             return false;
     }
 
- bool World::collidesWithLevel(Rectangle* rect) {
-	 for(int i=0; i < bricks->size(); i++){
-            if (bricks->get(i)->getBounds()->intersects(rect)
-            		&& bricks->get(i)->getTexture() !=background
-            		&& bricks->get(i)->getTexture() !=point
-                    && bricks->get(i)->getTexture() != bonus
-                    && bricks->get(i)->getTexture() != none
-                    ) {
-                return true;
-            }
-        }
-        return false;
-    }
+ bool World::collidesWithLevel(Rectangle rect) {
+	 return findTile(rect, TILE_WALL, NULL);
+ }
 
- int World::collidesWithRefresh(Rectangle* rect){
-	 for(int i=0; i < bricks->size(); i++){
-	            if (bricks->get(i)->getBounds()->intersects(rect) && bricks->get(i)->getTexture() == none) {
-	                return ATTACK;
-	            }
-	        }
-	        return DEAD;
+ int World::collidesWithRefresh(Rectangle rect){
+	 if (findTile(rect, TILE_DOOR, NULL)) {
+		 return ATTACK;
+	 }
+	 return DEAD;
  }
 
+ // A fresh player, lives included, on its starting cell.
  void World::startPointPlayer(){
-	 player = new Player(new Point(10,9),pacmanUpOpen,30,30);
-	 player->setDirection(LEFT);
+	 player = Player(level->pointPlayer,pacmanUpOpen,30,30);
+	 player.setDirection(LEFT);
  }
 
  void World::createSpirit(){
-	 for(int i=0; i < spirits->size(); i++){
-	 	            spirits->get(i)->setPositionPoint(spirits->get(i)->getStartPoint());
-	 	            spirits->get(i)->setCountStep(0);
+	 for(int i=0; i < spirits.size(); i++){
+		 Spirit::home(spirits, i);
+	 }
+ }
+
+ // Captures the world part of a Snapshot; the caller zero-fills it first.
+ // Only pellets and bonuses change in the grid, so the bitsets are copied
+ // byte by byte in cell order.
+ bool World::snapshot(Snapshot* snapshot){
+	 if (width * height > SNAPSHOT_CELLS || spirits.size() > SNAPSHOT_SPIRITS)
+		 return false;
+	 snapshot->score = score;
+	 snapshot->level = level->number;
+	 snapshot->countPoint = countPoint;
+	 snapshot->leftSpirit = leftSpirit;
+	 snapshot->spiritCount = spirits.size();
+	 player.save(&snapshot->player);
+	 for(int i=0; i < spirits.size(); i++){
+		 MoverSnapshot& spirit = snapshot->spirits[i];
+		 spirit.x = spirits.x[i];
+		 spirit.y = spirits.y[i];
+		 spirit.texture = spirits.texture[i];
+		 spirit.direction = spirits.direction[i];
+		 spirit.state = spirits.state[i];
+		 spirit.flag = spirits.white[i];
+	 }
+	 for(int i=0; i < levelBitWords(width, height); i++){
+		 for(int byte=0; byte < 4; byte++){
+			 snapshot->points[i * 4 + byte] = pellets[i] >> (byte * 8);
+			 snapshot->bonuses[i * 4 + byte] = power[i] >> (byte * 8);
+		 }
+	 }
+	 return true;
+ }
+
+ // Movers only ever head one of the four ways; anything else would stall
+ // them on the spot, and tryToPlayerGo would wait forever for a centre.
+ static bool validMover(const MoverSnapshot& mover){
+	 return isDirection(mover.direction)
+			 && mover.state >= ATTACK && mover.state <= DEAD;
+ }
+
+ // Whether snapshot could be restored once level is loaded: it was taken
+ // on that level with as many spirits as here, and carries no heading or
+ // state a mover cannot have.
+ bool World::canRestore(const Snapshot& snapshot, const Level* level){
+	 if (level->width * level->height > SNAPSHOT_CELLS || snapshot.spiritCount != spirits.size()
+			 || snapshot.level != level->number || !validMover(snapshot.player))
+		 return false;
+	 for(int i=0; i < spirits.size(); i++){
+		 if (!validMover(snapshot.spirits[i]))
+			 return false;
+	 }
+	 return true;
+ }
+
+ // Fails, changing nothing, unless canRestore() on the current level.
+ bool World::restore(const Snapshot& snapshot){
+	 if (!canRestore(snapshot, level))
+		 return false;
+	 score = snapshot.score;
+	 countPoint = snapshot.countPoint;
+	 leftSpirit = snapshot.leftSpirit;
+	 player.restore(snapshot.player);
+	 for(int i=0; i < spirits.size(); i++){
+		 const MoverSnapshot& spirit = snapshot.spirits[i];
+		 spirits.x[i] = spirit.x;
+		 spirits.y[i] = spirit.y;
+		 spirits.texture[i] = spirit.texture;
+		 spirits.direction[i] = spirit.direction;
+		 spirits.state[i] = spirit.state;
+		 spirits.white[i] = spirit.flag != 0;
+	 }
+	 for(int i=0; i < levelBitWords(width, height); i++){
+		 uint32_t points = 0, bonuses = 0;
+		 for(int byte=0; byte < 4; byte++){
+			 points |= (uint32_t) snapshot.points[i * 4 + byte] << (byte * 8);
+			 bonuses |= (uint32_t) snapshot.bonuses[i * 4 + byte] << (byte * 8);
+		 }
+		 markDirtyWord(i, (pellets[i] ^ points) | (power[i] ^ bonuses));
+		 pellets[i] = points;
+		 power[i] = bonuses;
 	 }
+	 playerMapCell = -1;
+	 return true;
  }
@@ -5,20 +5,69 @@
 #include "Point.h"
 #include "Brick.h"
 #include  "templates/list.h"
+#include "templates/AlignedArray.h"
 #include "View/ETexture.h"
 #include "log.h"
 #include "model/Spirit/Spirit.h"
+#include "model/Spirit/Movers.h"
 #include "Level.h"
-#include "View/Art.h"
+#include "LevelBlob.h"
+#include "Tile.h"
+#include "Snapshot.h"
+#include "GameEvent.h"
 
-class Spirit;
 class World {
     
  private:
-	 Player* player;
+	 Player player;
 
   int  width;
   int  height;
+  bool standard; // the level runs on the StandardGrid kernels
+  Level* level;
+  const uint8_t* tiles;
+  const uint8_t* textures;
+  AlignedArray<uint32_t> pellets;
+  AlignedArray<uint32_t> power;
+  const int* wallMap;
+  FloodMap playerMap;
+  FloodMap spiritMap;
+  int playerMapCell;
+  AlignedArray<uint32_t> dirtyTiles;
+  AlignedArray<int> dirtyCells;
+  int dirtyCount;
+  void markDirty(int index);
+  void markDirtyWord(int word, uint32_t bits);
+  NavTable* navTable;
+  // Distance each mover covers in a tick on this level.
+  fixed playerStep;
+  fixed poweredStep;
+  fixed spiritSteps[DEAD + 1]; // by spirit state
+  EventBuffer events;
+  bool findTile(Rectangle rect, int kind, int* index);
+  template <class Grid> bool findTile(const Grid& grid, Rectangle rect, int kind, int* index);
+  template <class Grid> void refill(const Grid& grid);
+  // Pellets come from the bitsets; the level's tiles only supply the
+  // walls, doors and floor under them.
+  template <class Grid> int getTile(const Grid& grid, int x, int y){
+	  if (x < 0 || y < 0 || x >= grid.width() || y >= grid.height())
+		  return TILE_WALL;
+	  int index = y * grid.width() + x;
+	  if (levelBit(pellets.data(), index))
+		  return TILE_POINT;
+	  if (levelBit(power.data(), index))
+		  return TILE_BONUS;
+	  int kind = tiles[index];
+	  return kind == TILE_POINT || kind == TILE_BONUS ? TILE_EMPTY : kind;
+  }
+  bool eatTile(Rectangle rect, int kind, int* index);
+  bool eatPoint();
+  bool eatBonus();
+  AlignedArray<int> gridHead;
+  AlignedArray<int> gridNext;
+  AlignedArray<int> gridCell;
+  AlignedArray<int> contacts;
+  void spiritContacts();
   int countPoint;
   int record;
   int score;
@@ -27,37 +76,65 @@ class World {
 
  public:
   World();
-  World(Level* level);
+  World(Level* level, int spiritCount = 4);
+  void loadLevel(Level* level);
+  int getLevelNumber(){return level->number;}
+  int getCountPoint(){return countPoint;}
   ~World();
 //     void startPointSpirit(Level level) ;
 //     void nextLevel(Level level, int record);
-	 List<Brick*>* bricks;
-	 List<Spirit*>* spirits;
+	 Movers spirits;
      void startPointPlayer();
      void createSpirit() ;
      void generateFruit();
-     bool collidesWithLevel(Rectangle* rect) ;
-     int collidesWithRefresh(Rectangle* rect);
+     bool collidesWithLevel(Rectangle rect) ;
+     int collidesWithRefresh(Rectangle rect);
      int generationPoint();
      void newGame();
      bool eatFruit();
-     bool eatPoint();
-     bool eatBonus();
-     void tryToPlayerGo(int direction);
+     bool tryToPlayerGo(int direction, int waited);
+     bool canEnter(fixed x, fixed y, int direction);
+     fixed getSpiritStep(int state){return spiritSteps[state];}
      void defenceNPC();
      void attackNPC() ;
-     bool deadPlayer ();
-     bool deadSpirit();
+     void beginTick(){events.clear();}
+     void resolveContacts();
+     void indexSpirits();
+     int touchingSpirits(Rectangle rect, int* ids);
+     const EventBuffer& getEvents(){return events;}
      bool isVictory();
      bool isGameOver();
-     int getWidth(){return 25;};
-     int getHeight(){return 15;} ;
+     bool isStandard(){return standard;}
+     int getWidth(){return width;};
+     int getHeight(){return height;} ;
+     int getTile(int x, int y){
+    	 if (standard)
+    		 return getTile(StandardGrid(), x, y);
+    	 return getTile(DynamicGrid(width, height), x, y);
+     }
+     // One bit per cell, row-major: points and bonuses still to be eaten.
+     const uint32_t* getPellets(){return pellets.data();}
+     const uint32_t* getPower(){return power.data();}
+     void restartLevel();
+     // Cells whose tile changed since the last clearDirtyTiles(), each
+     // listed once in the order they changed.
+     const int* getDirtyCells(){return dirtyCells.data();}
+     int getDirtyCount(){return dirtyCount;}
+     void clearDirtyTiles();
+     int getTexture(int index){return textures[index];}
+     const int* getWallMap(){return wallMap;}
+     const FloodMap* getPlayerMap();
+     NavTable* getNavTable(){return navTable;}
+     FloodMap* getSpiritMap(){return &spiritMap;}
      Player* getPlayer() ;
      int getRecord();
      void setRecord(int newRecord);
      int getScore();
      int leftSpirit;
      void setScore(int score);
+     bool snapshot(Snapshot* snapshot);
+     bool canRestore(const Snapshot& snapshot, const Level* level);
+     bool restore(const Snapshot& snapshot);
 //     Fruit getFruit();
     
 };
@@ -11,21 +11,21 @@ private:
 	int height;
 
 protected:
-     Point* position;
-     Rectangle* bounds;
+     Point position;
+     Rectangle bounds;
 
 public:
     WorldObject(){};
     virtual ~WorldObject();
-    WorldObject(Point* point, int texture, int width, int height);
+    WorldObject(Point point, int texture, int width, int height);
     int getWidth();
     int getHeight();
     void setWidth(int width);
     void setHeight(int height);
-    Point* getPosition();
-    void setPositionPoint(Point* point);
+    Point getPosition() const { return position; }
+    void setPositionPoint(Point point);
     int getTexture() ;
-    Rectangle* getBounds();
+    Rectangle getBounds() const { return bounds; }
     void setBounds(int x, int y, int width, int height);
     void setTexture(int texture);
     virtual void animate() {
@@ -1,21 +1,10 @@
 #include "WorldObjectMove.h"
 
-WorldObjectMove::WorldObjectMove(Point* point, int texture, int width, int height) :WorldObject(point,texture,width, height){
-	SPEED =5;
+// point is the starting cell.
+WorldObjectMove::WorldObjectMove(Point point, int texture, int width, int height) :WorldObject(point,texture,width, height){
     direction = UP;
- }
-
- void WorldObjectMove::onMove(int direction) {
-     switch (direction) {
-     case RIGHT:setNext(SPEED, 0);         break;
-     case LEFT: setNext(inverse(SPEED), 0);break;
-     case UP:   setNext(0, inverse(SPEED));break;
-     case DOWN: setNext(0, SPEED);         break;
-     }
- }
-
- int WorldObjectMove::getSpeed(){
-     return SPEED;
+    x = cellToFixed(point.getX());
+    y = cellToFixed(point.getY());
  }
 
  int WorldObjectMove::getState() {
@@ -34,21 +23,32 @@ WorldObjectMove::WorldObjectMove(Point* point, int texture, int width, int heigh
      this->direction = direction;
  }
 
- void WorldObjectMove::setPosition(Rectangle* rect) {
-     this->position = new Point(rect);
-     bounds = rect;
- }
-
- void WorldObjectMove::setNext(int speedX, int speedY) {
-     this->bounds = new Rectangle(position->getX() + speedX, position->getY()
-             + speedY, getWidth(), getHeight());
+ void WorldObjectMove::moveTo(fixed x, fixed y) {
+     this->x = x;
+     this->y = y;
+     position = Point(fixedToPixels(x), fixedToPixels(y));
+     bounds = Rectangle(position.getX(), position.getY(), getWidth(), getHeight());
  }
 
  int WorldObjectMove::getPointX(){
-     return position->getX() / getWidth();
+     return fixedToCell(x);
  }
 
   int WorldObjectMove::getPointY(){
-     return position->getY() / getHeight();
+     return fixedToCell(y);
+ }
+
+ void WorldObjectMove::save(MoverSnapshot* snapshot) {
+     snapshot->x = x;
+     snapshot->y = y;
+     snapshot->texture = getTexture();
+     snapshot->direction = direction;
+     snapshot->state = state;
  }
 
+ void WorldObjectMove::restore(const MoverSnapshot& snapshot) {
+     moveTo(snapshot.x, snapshot.y);
+     setTexture(snapshot.texture);
+     direction = snapshot.direction;
+     state = snapshot.state;
+ }
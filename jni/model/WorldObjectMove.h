@@ -3,26 +3,29 @@
 #include "Direction.h"
 #include "WorldObject.h"
 #include "State.h"
+#include "Snapshot.h"
+#include "Fixed.h"
 class WorldObjectMove: public WorldObject {
 
 protected:
 	int direction;
-	int SPEED;
 	int state;
+	fixed x, y; // top-left corner, see Fixed.h; position and bounds follow it in pixels
 
 public:
-	WorldObjectMove(Point* point, int texture, int width, int height);
+	WorldObjectMove(Point point, int texture, int width, int height);
 	virtual ~WorldObjectMove(){LOGI("WorldObjectMove::~WorldObjectMove finished");};
-	void onMove(int direction);
-	int getSpeed();
 	int getState();
 	int getDirection();
 	void setState(int state);
 	void setDirection(int direction);
-	void setPosition(Rectangle* rect);
-	void setNext(int speedX, int speedY);
+	fixed getX(){return x;}
+	fixed getY(){return y;}
+	void moveTo(fixed x, fixed y);
 	int getPointX();
 	int getPointY();
+	virtual void save(MoverSnapshot* snapshot);
+	virtual void restore(const MoverSnapshot& snapshot);
 
 };
 #endif /* WorldObjectMove_H_ */
@@ -1,10 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 #include <signal.h>
+#include <pthread.h>
 
 #include <jni.h>
 #include <android/asset_manager.h>
@@ -20,8 +22,13 @@
 #include "model/World.h"
 #include "Controller/WorldController.h"
 #include "View/Art.h"
+#include "View/WorldRenderer.h"
 #include "model/ReadLevel.h"
 #include "Controller/SoundController.h"
+#include "Controller/Replay.h"
+#include "Controller/LevelLoader.h"
+#include "Controller/InputLatency.h"
+#include "Controller/TouchQueue.h"
 
 
 #define MAX_ELAPSED_TIME 1000.0f
@@ -38,29 +45,86 @@ double up2Second;
 int framesCount;
 
 WorldController* worldController;
+WorldRenderer* worldRenderer;
 SoundController* soundController;
 World* world;
 ReadLevel* readLevel;
+LevelLoader* levelLoader;
+ReplayRecorder* recorder;
+InputLatency* latency;
+// Touches come in on the UI thread and are played on the GL thread at the
+// next tick. Static, so the UI thread never reaches into the game objects.
+static TouchQueue touchQueue;
+// Percentiles for latencyStats(), copied out by the GL thread once a
+// second so the UI thread never reads the windows being written.
+static const int LATENCY_STATS = LATENCY_STAGES * 3;
+static jfloat latencyStats[LATENCY_STATS];
+static pthread_mutex_t latencyLock = PTHREAD_MUTEX_INITIALIZER;
+char filesDir[256];
+
+// Where the game in progress is kept while the app is in the background.
+static void pausePath(char* path, size_t size){
+	snprintf(path, size, "%s/pause.snp", filesDir);
+}
 
-int second=0;
-bool leftDefenceSpirit;
+// p50, p95 and p99 in ms of each LatencyStage in turn; GL thread.
+static void publishLatency(){
+	static const double fractions[] = { 0.5, 0.95, 0.99 };
+	jfloat stats[LATENCY_STATS];
+	for (int stage = 0; stage < LATENCY_STAGES; stage++)
+		for (int i = 0; i < 3; i++)
+			stats[stage * 3 + i] = latency->percentile(stage, fractions[i]) / 1e6;
+	pthread_mutex_lock(&latencyLock);
+	memcpy(latencyStats, stats, sizeof(stats));
+	pthread_mutex_unlock(&latencyLock);
+}
+
+static void queueTouch(int action, float x, float y){
+	TouchEvent touch = { action, (int) x, (int) y, monotonicNanos() };
+	if(!touchQueue.push(touch))
+		LOGW("touch queue full, touch dropped");
+}
 
 extern "C" {
 
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_init(JNIEnv* env, jobject obj, jint width, jint height, jobject pngManager, jobject assetManager){
-		srand48(time(NULL));
+	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_init(JNIEnv* env, jobject obj, jint width, jint height, jobject pngManager, jobject assetManager, jstring javaFilesDir){
+		long seed = time(NULL);
+		srand48(seed);
 		lastTime = getTime();
 		up2Second = 0;
 		framesCount = 0;
+		pthread_mutex_lock(&latencyLock);
+		memset(latencyStats, 0, sizeof(latencyStats));
+		pthread_mutex_unlock(&latencyLock);
+		const char* dir = env->GetStringUTFChars(javaFilesDir, NULL);
+		strncpy(filesDir, dir, sizeof(filesDir) - 1);
+		env->ReleaseStringUTFChars(javaFilesDir, dir);
 		readLevel = new ReadLevel(env, assetManager);
+		readLevel->cacheDir = filesDir;
 		readLevel->loadLevels();
 		world = new World(readLevel->level);
-		worldController = new WorldController(world,new WorldRenderer(env, width,height, pngManager, assetManager));
+		worldRenderer = new WorldRenderer(env, width,height, pngManager, assetManager);
+		worldRenderer->setWorld(world);
+		worldController = new WorldController(world);
+		levelLoader = new LevelLoader(readLevel);
+		worldController->loader = levelLoader;
+		char path[512];
+		pausePath(path, sizeof(path));
+		if(worldController->onResume(path))
+			remove(path);
+		recorder = new ReplayRecorder(seed);
+		worldController->recorder = recorder;
+		latency = new InputLatency();
+		worldController->latency = latency;
+		// Touches made after the last free() belong to no game.
+		touchQueue.drain();
+		worldController->touches = &touchQueue;
 		soundController = new SoundController(world, env,assetManager);
 	}
 
-bool isCreate;
 	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_step(JNIEnv* env, jobject obj){
+		if(worldController == NULL)
+			return;
 		double time = getTime();
 		double elapsedTime = time - lastTime;
 		lastTime = time;
@@ -69,78 +133,89 @@ bool isCreate;
 			elapsedTime = MAX_ELAPSED_TIME;
 		}
 
+		int ticks = worldController->update(elapsedTime);
+		while(ticks-- > 0){
+			worldController->tick();
+			soundController->play();
+		}
 
-		worldController->worldRenderer->render();
+		worldRenderer->render();
+		latency->frame(monotonicNanos());
 
 		up2Second += elapsedTime;
 		++framesCount;
 		if(up2Second >= 1000){
-			LOGI("FPS: %d", framesCount);
+			LOGI("FPS: %d, swipe to frame p50 %.1f p95 %.1f ms", framesCount,
+					latency->percentile(INPUT_TO_FRAME, 0.5) / 1e6,
+					latency->percentile(INPUT_TO_FRAME, 0.95) / 1e6);
+			publishLatency();
 			up2Second = 0;
 			framesCount = 0;
 		}
-		isCreate=true;
-	}
-
-	bool leftTime;
-
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_attackSpirits(JNIEnv* env, jobject obj){
-		if(isCreate){
-			worldController->actionPerformedSpirit(leftDefenceSpirit);
-			if (worldController->world->getPlayer()->getState() == ATTACK) {
-			                    leftTime = true;
-			                }
-		}
 	}
 
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_pacmanMove(JNIEnv* env, jobject obj){
-		if(isCreate){
-			worldController->actionPerformed();
-			soundController->play();
-		}
+	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionDown(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
+		queueTouch(TOUCH_DOWN, x, y);
 	}
 
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_timeBonus(JNIEnv* env, jobject obj){
-		if(isCreate){
-			if(worldController->world->leftSpirit > 0)
-				worldController->world->leftSpirit--;
-			 if (leftTime) {
-			                    second++;
-			                    if (second >= 8 && second % 2 == 0) {
-			                        leftDefenceSpirit = true;
-			                    } else {
-			                        leftDefenceSpirit = false;
-			                    }
-
-			                    if (second >= 12) {
-			                        world->attackNPC();
-			                        leftDefenceSpirit = false;
-			                        second = 0;
-			                        leftTime = false;
-			                    }
-			            }
-		}
+	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionMove(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
+		queueTouch(TOUCH_MOVE, x, y);
 	}
 
-
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionDown(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
-		worldController->onTouch(TOUCH_DOWN, x, y);
+	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionUp(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
+		queueTouch(TOUCH_UP, x, y);
 	}
 
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionMove(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
-		worldController->onTouch(TOUCH_MOVE, x, y);
+	// Rolling p50, p95 and p99 in ms of each LatencyStage in turn, over the
+	// last turns taken, as of the last whole second played. Safe from any
+	// thread: it reads only the copy step() publishes.
+	JNIEXPORT jfloatArray JNICALL Java_com_pacman_free_PacmanLib_latencyStats(JNIEnv* env, jobject obj) {
+		jfloat stats[LATENCY_STATS];
+		pthread_mutex_lock(&latencyLock);
+		memcpy(stats, latencyStats, sizeof(stats));
+		pthread_mutex_unlock(&latencyLock);
+		jfloatArray result = env->NewFloatArray(LATENCY_STATS);
+		if (result != NULL)
+			env->SetFloatArrayRegion(result, 0, LATENCY_STATS, stats);
+		return result;
 	}
 
-	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_actionUp(JNIEnv* env, jobject obj, jfloat x, jfloat y) {
-		worldController->onTouch(TOUCH_UP, x, y);
+	JNIEXPORT void JNICALL Java_com_pacman_free_PacmanLib_pause(JNIEnv* env, jobject obj){
+		if(worldController == NULL)
+			return;
+		char path[512];
+		pausePath(path, sizeof(path));
+		if(!worldController->onPause(path))
+			LOGW("cannot save game to %s", path);
 	}
 
+	// Queued on the GL thread like step() and pause(), so neither can be
+	// part way through; both find the globals cleared afterwards.
 	JNIEXPORT jboolean JNICALL Java_com_pacman_free_PacmanLib_free(JNIEnv* env, jobject obj){
 		LOGI("native free");
-		isCreate=false;
+		if(worldController == NULL)
+			return JNI_FALSE;
 		delete soundController;
+		soundController = NULL;
+		char path[512];
+		snprintf(path, sizeof(path), "%s/last.rpl", filesDir);
+		recorder->save(path);
 		delete worldController;
+		worldController = NULL;
+		delete recorder;
+		recorder = NULL;
+		delete latency;
+		latency = NULL;
+		delete levelLoader;
+		levelLoader = NULL;
+		// The renderer owns the world.
+		delete worldRenderer;
+		worldRenderer = NULL;
+		world = NULL;
+		delete readLevel;
+		readLevel = NULL;
 		LOGI("native free OK");
+		return JNI_TRUE;
 	}
 
 }
@@ -0,0 +1,38 @@
+#ifndef ALIGNEDARRAY_H_
+#define ALIGNEDARRAY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Fixed-size heap array of plain data whose first element starts on a cache
+// line. Elements are not constructed; resize() keeps the storage when the
+// size does not change.
+template <class T, int ALIGNMENT = 64>
+class AlignedArray {
+private:
+	char* memory;
+	T* items;
+	int count;
+	AlignedArray (const AlignedArray&);
+	AlignedArray& operator= (const AlignedArray&);
+public:
+	AlignedArray () : memory(NULL), items(NULL), count(0) {}
+	~AlignedArray () { delete [] memory; }
+	void resize (int size);
+	T* data () const { return items; }
+	int size () const { return count; }
+	T& operator[] (int index) { return items[index]; }
+	const T& operator[] (int index) const { return items[index]; }
+};
+
+template <class T, int ALIGNMENT>
+void AlignedArray<T, ALIGNMENT>::resize (int size) {
+	if (size == count)
+		return;
+	delete [] memory;
+	memory = new char[size * sizeof(T) + ALIGNMENT - 1];
+	items = (T*) (((uintptr_t) memory + ALIGNMENT - 1) & ~(uintptr_t) (ALIGNMENT - 1));
+	count = size;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bump allocator for plain data that lives as long as its owner, such as
+// everything a level needs. Allocations start on a cache line and are
+// never freed one by one: reset() releases them all in one step. Blocks
+// added when the first ran out are folded into one on reset(), so once
+// the arena has held its largest load, filling it again allocates nothing.
+// mark() and release() undo the allocations made in between, for a load
+// that fails part way.
+class Arena {
+private:
+	static const size_t ALIGNMENT = 64;
+	char* memory;		// first block, as allocated
+	char* base;			// its first aligned byte
+	size_t capacity;
+	size_t used;
+	char* overflow;		// later blocks, each starting with the next one's address
+	size_t demand;		// bytes asked for since reset(), padding included
+	Arena (const Arena&);
+	Arena& operator= (const Arena&);
+
+	static size_t align (size_t bytes) { return (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+	void* allocateBytes (size_t bytes);
+	void freeOverflow ();
+public:
+	struct Mark {
+		size_t used;
+		char* overflow;
+		size_t demand;
+	};
+	Arena () : memory(NULL), base(NULL), capacity(0), used(0), overflow(NULL), demand(0) {}
+	~Arena () { freeOverflow(); delete [] memory; }
+	void reset ();
+	Mark mark () const { Mark mark = { used, overflow, demand }; return mark; }
+	void release (const Mark& mark);
+	template <class T> T* allocate (int count) { return (T*) allocateBytes(count * sizeof(T)); }
+	size_t getCapacity () const { return capacity; }
+};
+
+inline void* Arena::allocateBytes (size_t bytes) {
+	bytes = align(bytes ? bytes : 1);
+	demand += bytes;
+	if (used + bytes <= capacity) {
+		void* result = base + used;
+		used += bytes;
+		return result;
+	}
+	char* block = new char[ALIGNMENT + ALIGNMENT - 1 + bytes];
+	*(char**) block = overflow;
+	overflow = block;
+	return (void*) (((uintptr_t) block + ALIGNMENT + ALIGNMENT - 1) & ~(uintptr_t) (ALIGNMENT - 1));
+}
+
+inline void Arena::freeOverflow () {
+	while (overflow) {
+		char* next = *(char**) overflow;
+		delete [] overflow;
+		overflow = next;
+	}
+}
+
+inline void Arena::release (const Mark& mark) {
+	while (overflow != mark.overflow) {
+		char* next = *(char**) overflow;
+		delete [] overflow;
+		overflow = next;
+	}
+	used = mark.used;
+	demand = mark.demand;
+}
+
+inline void Arena::reset () {
+	if (overflow) {
+		freeOverflow();
+		delete [] memory;
+		capacity = demand;
+		memory = new char[capacity + ALIGNMENT - 1];
+		base = (char*) (((uintptr_t) memory + ALIGNMENT - 1) & ~(uintptr_t) (ALIGNMENT - 1));
+	}
+	used = 0;
+	demand = 0;
+}
+
+#endif
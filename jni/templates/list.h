@@ -1,76 +1,225 @@
 #ifndef ARRAYLIST_H
 #define ARRAYLIST_H
-template <class  T>
+
+#include <new>
+#include <string.h>
+#include <assert.h>
+
+// Growable array. Capacity doubles when it runs out, so n appends copy O(n)
+// items in all, and reserve() can size it up front. Only the first size()
+// slots hold constructed items. With INLINE > 0 the first INLINE items are
+// stored in the list itself, so a short list never touches the heap.
+// Indexing is checked with assert(), which compiles out of NDEBUG builds.
+// begin() and end() are plain pointers: for (T& item : list) works.
+//
+// Under C++11 items are moved rather than copied when the list grows or
+// shifts, and trivially copyable ones are shifted with memmove.
+
+#if __cplusplus >= 201103L
+#define LIST_MOVE(x) static_cast<T&&>(x)
+#define LIST_TRIVIAL(T) __is_trivially_copyable(T)
+#else
+#define LIST_MOVE(x) (x)
+#define LIST_TRIVIAL(T) false
+#endif
+
+template <class T, int INLINE = 0>
 class List {
 private:
-	static const int INITIALSIZE = 10;
-	static const int EXPANDSIZE = 5;
-	int capacity;		// Current list capacity
-	int count;			// Number of elements in list
-	T* items;			// Array of items in the list
-	void expand();		// Expands size of array by EXPANDSIZE
+	static const int MIN_CAPACITY = 8;
+	union Buffer {
+		double alignDouble;
+		long long alignLong;
+		void* alignPointer;
+		char bytes[(INLINE > 0 ? INLINE : 1) * sizeof(T)];
+	};
+	Buffer buffer;		// the INLINE slots
+	T* items;			// buffer.bytes, heap storage, or NULL
+	int count;			// Number of items in the list
+	int capacity;		// Slots in items
+	T* inlineItems () { return INLINE > 0 ? (T*) buffer.bytes : NULL; }
+	void grow (int minimum);
+	void open (int index);
 public:
 	List ();
-	~List () { delete [] items; }
+	List (const List& other);
+	List& operator= (const List& other);
+	~List ();
+	void reserve (int size) { if (size > capacity) grow(size); }
 	void append (const T& item);
-	void clear () { count = 0; }
-	T get (int index) const { return items[index]; }
+	void clear ();
+	const T& get (int index) const { assert(index >= 0 && index < count); return items[index]; }
+	T& operator[] (int index) { assert(index >= 0 && index < count); return items[index]; }
+	const T& operator[] (int index) const { assert(index >= 0 && index < count); return items[index]; }
 	void insert (int index, const T& item);
 	void remove (int index);
-	void set (int index, const T& item) { items[index] = item; }
+	void set (int index, const T& item) { assert(index >= 0 && index < count); items[index] = item; }
 	int size () const { return count; }
+	int getCapacity () const { return capacity; }
+	T* begin () { return items; }
+	T* end () { return items + count; }
+	const T* begin () const { return items; }
+	const T* end () const { return items + count; }
 	void traverse (void(*f)(const T&)) const;
 	void traverse (void(*f)(T&));
+#if __cplusplus >= 201103L
+	void append (T&& item);
+	void insert (int index, T&& item);
+#endif
 };
 
-template <class T>
-List<T>::List () {
-	items = new T[INITIALSIZE];
-	capacity = INITIALSIZE;
+template <class T, int INLINE>
+List<T, INLINE>::List () {
+	items = inlineItems();
 	count = 0;
+	capacity = INLINE;
 }
 
-template <class T>
-void List<T>::append (const T& item) {
-	if (count == capacity)
-		expand();
-	items[count++] = item;
+template <class T, int INLINE>
+List<T, INLINE>::List (const List& other) {
+	items = inlineItems();
+	count = 0;
+	capacity = INLINE;
+	*this = other;
+}
+
+template <class T, int INLINE>
+List<T, INLINE>& List<T, INLINE>::operator= (const List& other) {
+	if (this == &other)
+		return *this;
+	clear();
+	reserve(other.count);
+	for (int i = 0; i < other.count; i++)
+		new (items + i) T(other.items[i]);
+	count = other.count;
+	return *this;
 }
 
-template <class T>
-void List<T>::expand () {
-	T* tmp = new T[capacity += EXPANDSIZE];
+template <class T, int INLINE>
+List<T, INLINE>::~List () {
+	clear();
+	if (items != inlineItems())
+		::operator delete(items);
+}
+
+template <class T, int INLINE>
+void List<T, INLINE>::clear () {
 	for (int i = 0; i < count; i++)
-		tmp[i] = items[i];
-	delete [] items;
+		items[i].~T();
+	count = 0;
+}
+
+// Moves the items to storage for at least minimum of them, doubling the
+// capacity at the least.
+template <class T, int INLINE>
+void List<T, INLINE>::grow (int minimum) {
+	int size = capacity * 2 > MIN_CAPACITY ? capacity * 2 : MIN_CAPACITY;
+	if (size < minimum)
+		size = minimum;
+	T* tmp = (T*) ::operator new(size * sizeof(T));
+	if (LIST_TRIVIAL(T)) {
+		if (count)
+			memcpy((void*) tmp, (const void*) items, count * sizeof(T));
+	} else {
+		for (int i = 0; i < count; i++) {
+			new (tmp + i) T(LIST_MOVE(items[i]));
+			items[i].~T();
+		}
+	}
+	if (items != inlineItems())
+		::operator delete(items);
 	items = tmp;
+	capacity = size;
+}
+
+template <class T, int INLINE>
+void List<T, INLINE>::append (const T& item) {
+	if (count == capacity) {
+		T copy(item);	// item may be one of ours
+		grow(count + 1);
+		new (items + count) T(LIST_MOVE(copy));
+	} else
+		new (items + count) T(item);
+	count++;
 }
 
-template <class T>
-void List<T>::insert (int index, const T& item) {
+// Makes room at index, which must be below count, leaving a live item
+// there to be assigned over. capacity must exceed count.
+template <class T, int INLINE>
+void List<T, INLINE>::open (int index) {
+	if (LIST_TRIVIAL(T)) {
+		memmove((void*) (items + index + 1), (const void*) (items + index), (count - index) * sizeof(T));
+		return;
+	}
+	new (items + count) T(LIST_MOVE(items[count - 1]));
+	for (int i = count - 1; i > index; i--)
+		items[i] = LIST_MOVE(items[i - 1]);
+}
+
+template <class T, int INLINE>
+void List<T, INLINE>::insert (int index, const T& item) {
+	assert(index >= 0 && index <= count);
+	T copy(item);	// item may be one of those about to move
 	if (count == capacity)
-		expand();
-	for (int i = count - 1; i >= index; i--)
-		items[i + 1] = items[i];
-	items[index] = item;
+		grow(count + 1);
+	if (index == count)
+		new (items + count) T(LIST_MOVE(copy));
+	else {
+		open(index);
+		items[index] = LIST_MOVE(copy);
+	}
 	count++;
 }
 
-template <class T>
-void List<T>::remove (int index) {
-	for (int i = index + 1; i < count; i++)
-		items[i - 1] = items[i];
+template <class T, int INLINE>
+void List<T, INLINE>::remove (int index) {
+	assert(index >= 0 && index < count);
+	if (LIST_TRIVIAL(T)) {
+		memmove((void*) (items + index), (const void*) (items + index + 1), (count - index - 1) * sizeof(T));
+	} else {
+		for (int i = index + 1; i < count; i++)
+			items[i - 1] = LIST_MOVE(items[i]);
+		items[count - 1].~T();
+	}
 	count--;
 }
 
-template <class T>
-void List<T>::traverse (void(*f)(const T&)) const {
+#if __cplusplus >= 201103L
+template <class T, int INLINE>
+void List<T, INLINE>::append (T&& item) {
+	if (count == capacity) {
+		T moved(LIST_MOVE(item));
+		grow(count + 1);
+		new (items + count) T(LIST_MOVE(moved));
+	} else
+		new (items + count) T(LIST_MOVE(item));
+	count++;
+}
+
+template <class T, int INLINE>
+void List<T, INLINE>::insert (int index, T&& item) {
+	assert(index >= 0 && index <= count);
+	T moved(LIST_MOVE(item));
+	if (count == capacity)
+		grow(count + 1);
+	if (index == count)
+		new (items + count) T(LIST_MOVE(moved));
+	else {
+		open(index);
+		items[index] = LIST_MOVE(moved);
+	}
+	count++;
+}
+#endif
+
+template <class T, int INLINE>
+void List<T, INLINE>::traverse (void(*f)(const T&)) const {
 	for (int i = 0; i < count; i++)
 		f(items[i]);
 }
 
-template <class T>
-void List<T>::traverse (void(*f)(T&)) {
+template <class T, int INLINE>
+void List<T, INLINE>::traverse (void(*f)(T&)) {
 	for (int i = 0; i < count; i++)
 		f(items[i]);
 }
@@ -1,14 +1,11 @@
 package com.pacman.free;
 
-import java.util.Timer;
-import java.util.TimerTask;
-
 import android.os.Bundle;
 import android.app.Activity;
+import android.util.Log;
 import android.view.KeyEvent;
 
 public class PacmanActivity extends Activity{
-	Timer mainTimer;
 	PacmanView pacmanView;
 	
     @Override
@@ -16,37 +13,18 @@ public class PacmanActivity extends Activity{
        super.onCreate(savedInstanceState);
       
        pacmanView = new PacmanView(getApplication());
-       mainTimer = new Timer();
-       mainTimer.schedule(attackSpirits, 1, 60);
-       mainTimer.schedule(pacmanMove, 1, 50);
-       mainTimer.schedule(timeBonus, 1, 1000);
        setContentView(pacmanView);   
     }
 
-    TimerTask attackSpirits = new TimerTask() {
-		@Override
-		public void run() {
-			PacmanLib.attackSpirits();			
-		}
-	};
-	
-	TimerTask pacmanMove = new TimerTask() {
-		@Override
-		public void run() {
-			PacmanLib.pacmanMove();		
-		}
-	};
-	
-	TimerTask timeBonus = new TimerTask() {
-		@Override
-		public void run() {
-			PacmanLib.timeBonus();		
-		}
-	};
-    
     @Override
     protected void onPause() {
         super.onPause();
+        // Saved on the GL thread so the snapshot never lands mid-step.
+        pacmanView.queueEvent(new Runnable() {
+            public void run() {
+                PacmanLib.pause();
+            }
+        });
     }
 
     @Override
@@ -57,7 +35,13 @@ public class PacmanActivity extends Activity{
     @Override
     protected void onStop() {
         super.onStop();
-        PacmanLib.free();
+        // Freed on the GL thread as well, after any step or pause before it.
+        pacmanView.queueEvent(new Runnable() {
+            public void run() {
+                if (!PacmanLib.free())
+                    Log.w(PacmanLib.tag, "game already freed");
+            }
+        });
         finish();
     }
     
@@ -10,16 +10,19 @@ public class PacmanLib {
 	
 	public static final String tag = "pacman";
 	
-	public static native void init(int width, int height, PngManager pngManager, AssetManager assetManager);
+	public static native void init(int width, int height, PngManager pngManager, AssetManager assetManager, String filesDir);
 	public static native void step();
 	
-	public static native void attackSpirits();
-	public static native void timeBonus();
-	public static native void pacmanMove();
-	
 	public static native void actionUp(float x, float y);
     public static native void actionDown(float x, float y);
     public static native void actionMove(float x, float y);
 	
-	public static native void free();
+	// p50, p95 and p99 in ms for touch to turn, turn to frame and touch to
+	// frame, in that order. Refreshed once a second by step(); safe to call
+	// from any thread.
+	public static native float[] latencyStats();
+
+	public static native void pause();
+	// False if there was no game to free.
+	public static native boolean free();
 }
@@ -12,10 +12,12 @@ import android.view.MotionEvent;
 public class PacmanView extends GLSurfaceView {
 
 	private static AssetManager assetManager;
+	private static String filesDir;
 
 	public PacmanView(Context context) {
 		super(context);
 		assetManager = context.getAssets();
+		filesDir = context.getFilesDir().getAbsolutePath();
 		setEGLContextClientVersion(2);
 
 		setRenderer(new PacmanRenderer());
@@ -31,7 +33,7 @@ public class PacmanView extends GLSurfaceView {
 
 		public void onSurfaceChanged(GL10 unused, int width, int height) {
 			PacmanLib.init(width, height, new PngManager(assetManager),
-					assetManager);
+					assetManager, filesDir);
 		}
 	}
 